@@ -1,4 +1,7 @@
+#pragma once
+
 #include "data.h"
+#include "parallel.h"
 #include <algorithm>
 #include <expected>
 #include <queue>
@@ -8,8 +11,8 @@
 
 namespace GraphLib::algorithm {
 
-template <isVertex V>
-void addOrRemove(Graph<V>& graph, const std::vector<Edge>& edges) {
+template <isVertex V, isDirectedness D>
+void addOrRemove(Graph<V, D>& graph, const std::vector<Edge>& edges) {
     for(const auto& ed: edges) {
         if(!graph.delEdge(ed.id)) {
             graph.addEdge(ed);
@@ -17,8 +20,8 @@ void addOrRemove(Graph<V>& graph, const std::vector<Edge>& edges) {
     }
 }
 
-template <isVertex V>
-std::vector<int> tarjan(const Graph<V>& graph) {
+template <isGraphView G>
+std::vector<int> tarjan(const G& graph) {
     const auto vertices = graph.getAllVertices();
     const auto n = vertices.size();
     std::unordered_map<int, int> idToIndex;
@@ -48,7 +51,7 @@ std::vector<int> tarjan(const Graph<V>& graph) {
 
         for(int edgeId: edgeIds) {
             const auto& edge = graph.getEdge(edgeId);
-            int toIndex = idToIndex[edge.to];
+            int toIndex = idToIndex[edge.other(vertices[index - 1].id)];
 
             if(!vis[toIndex]) {
                 parent[toIndex] = index;
@@ -82,8 +85,8 @@ std::vector<int> tarjan(const Graph<V>& graph) {
     return cuts;
 }
 
-template <isVertex V>
-int distanceWithoutWeight(const Graph<V>& graph, int from, int to) {
+template <isGraphView G>
+int distanceWithoutWeight(const G& graph, int from, int to) {
     if(from == to) {
         return 0;
     }
@@ -111,21 +114,21 @@ int distanceWithoutWeight(const Graph<V>& graph, int from, int to) {
         const auto edgeIds = *edgeIdsExp;
 
         for(int edgeId: edgeIds) {
-            const auto& edge = graph.getEdge(edgeId);
-            if(!visited.count(edge.to)) {
-                dist[edge.to] = dist[curr] + 1;
-                if(edge.to == to) {
-                    return dist[edge.to];
+            int next = graph.getEdge(edgeId).other(curr);
+            if(!dist.count(next)) {
+                dist[next] = dist[curr] + 1;
+                if(next == to) {
+                    return dist[next];
                 }
-                q.push(edge.to);
+                q.push(next);
             }
         }
     }
     return -1;
 }
 
-template <isVertex V>
-std::expected<std::vector<int>, std::string> isBipartite(const Graph<V>& graph) {
+template <isGraphView G>
+std::expected<std::vector<int>, std::string> isBipartite(const G& graph) {
     auto vertices = graph.getAllVertices();
     std::unordered_map<int, int> idToIndex;
     for(int i = 0; i < vertices.size(); i++) {
@@ -145,7 +148,7 @@ std::expected<std::vector<int>, std::string> isBipartite(const Graph<V>& graph)
 
         for(int edgeId: edgeIds) {
             const auto& edge = graph.getEdge(edgeId);
-            int toIndex = idToIndex[edge.to];
+            int toIndex = idToIndex[edge.other(vertices[index].id)];
 
             if(color[toIndex] == -1) {
                 if(!self(self, toIndex, 1 - c)) {
@@ -177,8 +180,8 @@ std::expected<std::vector<int>, std::string> isBipartite(const Graph<V>& graph)
 }
 
 /// You must ensure the graph is bipartite before using this function.
-template <isVertex V>
-std::unordered_map<int, int> getMaxMatchByHopcraftKarp(Graph<V>& graph,
+template <isGraphView G>
+std::unordered_map<int, int> getMaxMatchByHopcraftKarp(const G& graph,
                                                        const std::vector<int>& onePartIds) {
     std::vector<int> part1 = onePartIds, part2;
     const auto vertices = graph.getAllVertices();
@@ -234,7 +237,7 @@ std::unordered_map<int, int> getMaxMatchByHopcraftKarp(Graph<V>& graph,
 
             for(int edgeId: edgeIds) {
                 const auto& edge = graph.getEdge(edgeId);
-                int v = idToIndex[edge.to];
+                int v = idToIndex[edge.other(vertices[u].id)];
 
                 if(dy[v] == -1) {
                     dy[v] = dx[u] + 1;
@@ -259,7 +262,7 @@ std::unordered_map<int, int> getMaxMatchByHopcraftKarp(Graph<V>& graph,
 
         for(int edgeId: edgeIds) {
             const auto& edge = graph.getEdge(edgeId);
-            int v = idToIndex[edge.to];
+            int v = idToIndex[edge.other(vertices[u].id)];
 
             if(!vis[v] && dy[v] == dx[u] + 1) {
                 vis[v] = true;
@@ -312,4 +315,27 @@ std::unordered_map<int, int> getMaxMatchByHopcraftKarp(Graph<V>& graph,
     return matchMap;
 }
 
+// 以下算法本身是顺序的, 接受执行策略只是为了统一调用方式, 任何策略都在调用线程上运行
+template <execution::isExecutionPolicy P, isGraphView G>
+std::vector<int> tarjan(const P&, const G& graph) {
+    return tarjan(graph);
+}
+
+template <execution::isExecutionPolicy P, isGraphView G>
+int distanceWithoutWeight(const P&, const G& graph, int from, int to) {
+    return distanceWithoutWeight(graph, from, to);
+}
+
+template <execution::isExecutionPolicy P, isGraphView G>
+std::expected<std::vector<int>, std::string> isBipartite(const P&, const G& graph) {
+    return isBipartite(graph);
+}
+
+template <execution::isExecutionPolicy P, isGraphView G>
+std::unordered_map<int, int> getMaxMatchByHopcraftKarp(const P&,
+                                                       const G& graph,
+                                                       const std::vector<int>& onePartIds) {
+    return getMaxMatchByHopcraftKarp(graph, onePartIds);
+}
+
 }  // namespace GraphLib::algorithm
@@ -0,0 +1,251 @@
+#pragma once
+
+#include "algorithm.h"
+#include "data.h"
+#include <algorithm>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace GraphLib {
+
+// 结果大致占用的字节数, 用于缓存的内存上限
+template <typename R>
+size_t approximateBytes(const R& result) {
+    size_t bytes = sizeof(R);
+    if constexpr(requires { result.has_value(); result.error(); }) {
+        if(result.has_value())
+            bytes += approximateBytes(*result);
+        else
+            bytes += approximateBytes(result.error());
+    } else if constexpr(requires { result.bucket_count(); }) {
+        bytes += hashTableBytes(result);
+    } else if constexpr(requires {
+                            typename R::value_type;
+                            result.capacity();
+                        }) {
+        bytes += result.capacity() * sizeof(typename R::value_type);
+    }
+    return bytes;
+}
+
+// 以 (算法, 参数, 图实例, epoch) 为键的 LRU 结果缓存. 图一旦被修改 epoch 就会变化,
+// 旧结果再也不会命中, 并在下一次查询这张图时被整体清掉. 每张图的簿记只在它还有缓存结果时保留,
+// 最后一个结果被淘汰时一起删除. 线程安全, 计算在锁外进行
+class QueryCache {
+public:
+    explicit QueryCache(size_t capacityBytes) : capacityBytes(capacityBytes) {}
+
+    template <typename R, typename G, typename F>
+    std::shared_ptr<const R> getOrCompute(std::string_view algorithm,
+                                          std::vector<int> args,
+                                          const G& graph,
+                                          F&& compute) {
+        Key key{std::string(algorithm), std::move(args), graph.instanceId(), graph.epoch()};
+        {
+            std::lock_guard lock(mutex);
+            dropStale(key.graph, key.epoch);
+            if(auto it = index.find(key); it != index.end() && *it->second->type == typeid(R)) {
+                lru.splice(lru.begin(), lru, it->second);
+                hitCount++;
+                return std::static_pointer_cast<const R>(it->second->result);
+            }
+            missCount++;
+        }
+
+        auto result = std::make_shared<const R>(compute());
+        size_t bytes = sizeof(Entry) + key.algorithm.capacity() + key.args.capacity() * sizeof(int) +
+                       approximateBytes(*result);
+        std::lock_guard lock(mutex);
+        auto known = graphs.find(key.graph);
+        if(bytes > capacityBytes || (known != graphs.end() && key.epoch < known->second.epoch))
+            return result;
+        if(auto it = index.find(key); it != index.end())
+            erase(it->second);
+        auto& state = graphs[key.graph];
+        state.epoch = std::max(state.epoch, key.epoch);
+        state.entries++;
+        lru.push_front(Entry{key, result, &typeid(R), bytes});
+        index.emplace(std::move(key), lru.begin());
+        usedBytes += bytes;
+        while(usedBytes > capacityBytes)
+            erase(std::prev(lru.end()));
+        return result;
+    }
+
+    // 主动丢弃某张图的全部结果, 例如图被析构时
+    void invalidate(uint64_t graph) {
+        std::lock_guard lock(mutex);
+        eraseIf([&](const Entry& entry) { return entry.key.graph == graph; });
+    }
+
+    void clear() {
+        std::lock_guard lock(mutex);
+        lru.clear();
+        index.clear();
+        graphs.clear();
+        usedBytes = 0;
+    }
+
+    [[nodiscard]] size_t size() const {
+        std::lock_guard lock(mutex);
+        return lru.size();
+    }
+
+    // 仍有缓存结果的图的个数
+    [[nodiscard]] size_t numGraphs() const {
+        std::lock_guard lock(mutex);
+        return graphs.size();
+    }
+
+    [[nodiscard]] size_t bytes() const {
+        std::lock_guard lock(mutex);
+        return usedBytes;
+    }
+
+    [[nodiscard]] size_t hits() const {
+        std::lock_guard lock(mutex);
+        return hitCount;
+    }
+
+    [[nodiscard]] size_t misses() const {
+        std::lock_guard lock(mutex);
+        return missCount;
+    }
+
+private:
+    struct Key {
+        std::string algorithm;
+        std::vector<int> args;
+        uint64_t graph;
+        uint64_t epoch;
+
+        bool operator== (const Key& rhs) const = default;
+    };
+
+    struct KeyHasher {
+        size_t operator() (const Key& key) const noexcept {
+            size_t h = std::hash<std::string>()(key.algorithm);
+            auto mix = [&](uint64_t value) {
+                h ^= std::hash<uint64_t>()(value) + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2);
+            };
+            for(int arg: key.args)
+                mix(arg);
+            mix(key.graph);
+            mix(key.epoch);
+            return h;
+        }
+    };
+
+    struct Entry {
+        Key key;
+        std::shared_ptr<const void> result;
+        const std::type_info* type;
+        size_t bytes;
+    };
+
+    // 已缓存的最新 epoch 与结果个数
+    struct GraphState {
+        uint64_t epoch = 0;
+        size_t entries = 0;
+    };
+
+    using Iterator = std::list<Entry>::iterator;
+
+    void erase(Iterator it) {
+        usedBytes -= it->bytes;
+        if(auto state = graphs.find(it->key.graph); --state->second.entries == 0)
+            graphs.erase(state);
+        index.erase(it->key);
+        lru.erase(it);
+    }
+
+    template <typename Pred>
+    void eraseIf(Pred&& pred) {
+        for(auto it = lru.begin(); it != lru.end();) {
+            auto next = std::next(it);
+            if(pred(*it))
+                erase(it);
+            it = next;
+        }
+    }
+
+    // 第一次看到更新的 epoch 时, 清掉这张图所有旧 epoch 的结果
+    void dropStale(uint64_t graph, uint64_t epoch) {
+        auto it = graphs.find(graph);
+        if(it == graphs.end() || epoch <= it->second.epoch)
+            return;
+        eraseIf([&](const Entry& entry) { return entry.key.graph == graph && entry.key.epoch < epoch; });
+    }
+
+    size_t capacityBytes;
+    size_t usedBytes = 0;
+    size_t hitCount = 0;
+    size_t missCount = 0;
+    std::list<Entry> lru;  // 越靠前越近被使用
+    std::unordered_map<Key, Iterator, KeyHasher> index;
+    std::unordered_map<uint64_t, GraphState> graphs;
+    mutable std::mutex mutex;
+};
+
+}  // namespace GraphLib
+
+namespace GraphLib::algorithm {
+
+template <isVertex V, isDirectedness D>
+int cachedDistanceWithoutWeight(QueryCache& cache, const Graph<V, D>& graph, int from, int to) {
+    return *cache.getOrCompute<int>("distanceWithoutWeight", {from, to}, graph, [&] {
+        return distanceWithoutWeight(graph, from, to);
+    });
+}
+
+// 命中时不复制结果; 返回的指针与缓存共享所有权, 结果被淘汰或图被修改后仍然有效
+template <isVertex V, isDirectedness D>
+std::shared_ptr<const std::expected<std::vector<int>, std::string>>
+cachedIsBipartite(QueryCache& cache, const Graph<V, D>& graph) {
+    return cache.getOrCompute<std::expected<std::vector<int>, std::string>>(
+        "isBipartite", {}, graph, [&] { return isBipartite(graph); });
+}
+
+template <isVertex V, isDirectedness D>
+std::shared_ptr<const std::vector<int>> cachedTarjan(QueryCache& cache, const Graph<V, D>& graph) {
+    return cache.getOrCompute<std::vector<int>>("tarjan", {}, graph, [&] { return tarjan(graph); });
+}
+
+// 未命中时按 policy 计算; 结果与策略无关, 不同策略共享同一个缓存项
+template <execution::isExecutionPolicy P, isVertex V, isDirectedness D>
+int cachedDistanceWithoutWeight(const P& policy,
+                                QueryCache& cache,
+                                const Graph<V, D>& graph,
+                                int from,
+                                int to) {
+    return *cache.getOrCompute<int>("distanceWithoutWeight", {from, to}, graph, [&] {
+        return distanceWithoutWeight(policy, graph, from, to);
+    });
+}
+
+template <execution::isExecutionPolicy P, isVertex V, isDirectedness D>
+std::shared_ptr<const std::expected<std::vector<int>, std::string>>
+cachedIsBipartite(const P& policy, QueryCache& cache, const Graph<V, D>& graph) {
+    return cache.getOrCompute<std::expected<std::vector<int>, std::string>>(
+        "isBipartite", {}, graph, [&] { return isBipartite(policy, graph); });
+}
+
+template <execution::isExecutionPolicy P, isVertex V, isDirectedness D>
+std::shared_ptr<const std::vector<int>> cachedTarjan(const P& policy,
+                                                     QueryCache& cache,
+                                                     const Graph<V, D>& graph) {
+    return cache.getOrCompute<std::vector<int>>("tarjan", {}, graph,
+                                                [&] { return tarjan(policy, graph); });
+}
+
+}  // namespace GraphLib::algorithm
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "data.h"
+#include <algorithm>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace GraphLib {
+
+// 图的只读连续快照: 顶点按 id 排序后编号为 0..n-1, 邻接按 CSR 存放.
+// 无向图的每条边在两个端点下各出现一次
+struct CsrGraph {
+    std::vector<int> ids;      // index -> vertex id
+    std::vector<int> offsets;  // size n + 1
+    std::vector<int> targets;  // 邻居的 index
+    std::vector<int> edgeIds;
+    std::vector<int> weights;
+    std::unordered_map<int, int> idToIndex;
+
+    [[nodiscard]] int numVertices() const {
+        return ids.size();
+    }
+
+    [[nodiscard]] int numArcs() const {
+        return targets.size();
+    }
+
+    [[nodiscard]] int degree(int index) const {
+        return offsets[index + 1] - offsets[index];
+    }
+
+    [[nodiscard]] std::span<const int> neighbors(int index) const {
+        return {targets.data() + offsets[index], targets.data() + offsets[index + 1]};
+    }
+
+    [[nodiscard]] std::span<const int> weightsOf(int index) const {
+        return {weights.data() + offsets[index], weights.data() + offsets[index + 1]};
+    }
+
+    // 不存在时返回 -1
+    [[nodiscard]] int indexOf(int id) const {
+        auto it = idToIndex.find(id);
+        return it == idToIndex.end() ? -1 : it->second;
+    }
+};
+
+// 只保留两端都在图中的边
+template <isGraphView G>
+CsrGraph toCsr(const G& graph) {
+    CsrGraph csr;
+    csr.ids.reserve(graph.numVertices());
+    graph.forEachVertex([&](const typename G::VertexTy& v) { csr.ids.push_back(v.id); });
+    std::sort(csr.ids.begin(), csr.ids.end());
+    const int n = csr.ids.size();
+    csr.idToIndex.reserve(n);
+    for(int i = 0; i < n; i++) {
+        csr.idToIndex.emplace(csr.ids[i], i);
+    }
+    csr.offsets.assign(n + 1, 0);
+    for(int i = 0; i < n; i++) {
+        if(auto edgeIds = graph.getEdgeIdsOfVertex(csr.ids[i])) {
+            for(int edgeId: *edgeIds) {
+                const auto& edge = graph.getEdge(edgeId);
+                int to = csr.indexOf(edge.other(csr.ids[i]));
+                if(to < 0)
+                    continue;
+                csr.targets.push_back(to);
+                csr.edgeIds.push_back(edgeId);
+                csr.weights.push_back(edge.weight);
+            }
+        }
+        csr.offsets[i + 1] = csr.targets.size();
+    }
+    return csr;
+}
+
+// 反向图, 即每个顶点的入边
+inline CsrGraph transpose(const CsrGraph& csr) {
+    CsrGraph rev;
+    rev.ids = csr.ids;
+    rev.idToIndex = csr.idToIndex;
+    const int n = csr.numVertices();
+    rev.offsets.assign(n + 1, 0);
+    for(int to: csr.targets) {
+        rev.offsets[to + 1]++;
+    }
+    for(int i = 0; i < n; i++) {
+        rev.offsets[i + 1] += rev.offsets[i];
+    }
+    rev.targets.resize(csr.numArcs());
+    rev.edgeIds.resize(csr.numArcs());
+    rev.weights.resize(csr.numArcs());
+    std::vector<int> cursor(rev.offsets.begin(), rev.offsets.end() - 1);
+    for(int from = 0; from < n; from++) {
+        for(int k = csr.offsets[from]; k < csr.offsets[from + 1]; k++) {
+            int pos = cursor[csr.targets[k]]++;
+            rev.targets[pos] = from;
+            rev.edgeIds[pos] = csr.edgeIds[k];
+            rev.weights[pos] = csr.weights[k];
+        }
+    }
+    return rev;
+}
+
+// 去掉方向、重边和自环后的简单无向图, 只保留邻居, 不带边 id 和权重
+inline CsrGraph simpleUndirected(const CsrGraph& csr) {
+    const CsrGraph rev = transpose(csr);
+    CsrGraph simple;
+    simple.ids = csr.ids;
+    simple.idToIndex = csr.idToIndex;
+    const int n = csr.numVertices();
+    simple.offsets.assign(n + 1, 0);
+    simple.targets.reserve(csr.numArcs() * 2);
+    for(int v = 0; v < n; v++) {
+        const auto begin = simple.targets.size();
+        for(const auto* adj: {&csr, &rev}) {
+            for(int u: adj->neighbors(v)) {
+                if(u != v)
+                    simple.targets.push_back(u);
+            }
+        }
+        std::sort(simple.targets.begin() + begin, simple.targets.end());
+        simple.targets.erase(std::unique(simple.targets.begin() + begin, simple.targets.end()),
+                             simple.targets.end());
+        simple.offsets[v + 1] = simple.targets.size();
+    }
+    return simple;
+}
+
+}  // namespace GraphLib
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
 #include <expected>
 #include <format>
 #include <functional>
@@ -15,25 +18,19 @@ namespace GraphLib {
 template <typename T, typename CharT = char>
 concept Formattable = requires(T t, std::format_context ctx) { typename std::formatter<T, CharT>; };
 
-class UndirectedEdgeIdCounter {
-public:
-    int getNextId() {
-        currentId += 2;
-        return currentId;
-    };
-
-    static int getPairedId(int id) {
-        if(id % 2 == 0) {
-            return id - 1;
-        } else {
-            return id + 1;
-        }
-    };
+// 方向策略: 作为 Graph 的模板参数在编译期决定边的存储方式, 不需要 virtual
+struct Directed {
+    static constexpr bool isDirected = true;
+};
 
-private:
-    int currentId = 0;
+// 无向边只存一份, 两个端点的邻接表引用同一个边 id
+struct Undirected {
+    static constexpr bool isDirected = false;
 };
 
+template <typename D>
+concept isDirectedness = std::is_same_v<D, Directed> || std::is_same_v<D, Undirected>;
+
 struct VertexBase {
     const int id;
 
@@ -55,10 +52,14 @@ struct Vertex : public VertexBase {
     DataTy data;
     using VertexBase::VertexBase;
 
-    Vertex(int id, const DataTy d) : VertexBase(id), data(std::move(d)) {}
+    Vertex(int id, DataTy d) : VertexBase(id), data(std::move(d)) {}
 
     Vertex<DataTy>(const Vertex<DataTy>& other) : VertexBase(other.id), data(other.data) {}
 
+    // 声明了拷贝构造后不会再隐式生成移动构造, 这里补上, 重新编号时可以移走 data
+    Vertex(Vertex&& other) noexcept(std::is_nothrow_move_constructible_v<DataTy>) :
+        VertexBase(other.id), data(std::move(other.data)) {}
+
     [[nodiscard]] std::string toString() const {
         if constexpr(Formattable<DataTy>) {
             return std::format("vertex<{}: {}>", id, data);
@@ -97,6 +98,11 @@ struct Edge {
         return id == rhs.id;
     }
 
+    // 从端点 v 沿这条边走到的另一端, 有向边总是 to
+    int other(int v) const {
+        return v == from ? to : from;
+    }
+
     std::string toString() const {
         return std::format("edge<{}: {} -> {}>", id, from, to);
     }
@@ -126,7 +132,95 @@ struct GraphData {
     GraphData() {}
 };
 
-template <isVertex V>
+// 各部分占用的字节数. 按哈希表的桶数组加节点 (next 指针, 缓存的 hash, 元素) 估算,
+// 不包含分配器自身的开销
+struct MemoryUsage {
+    size_t adjacency = 0;
+    size_t vertexMap = 0;
+    size_t edgeMap = 0;
+    size_t vertexData = 0;
+
+    [[nodiscard]] size_t total() const {
+        return adjacency + vertexMap + edgeMap + vertexData;
+    }
+};
+
+// 重新编号后的映射: 下标是新 id, 值是旧 id
+struct Renumbering {
+    std::vector<int> vertexIds;
+    std::vector<int> edgeIds;
+};
+
+template <typename HashTable>
+size_t hashTableBytes(const HashTable& table) {
+    constexpr size_t nodeBytes =
+        sizeof(void*) + sizeof(size_t) + sizeof(typename HashTable::value_type);
+    return table.bucket_count() * sizeof(void*) + table.size() * nodeBytes;
+}
+
+// data 自己在堆上持有的字节数, 只认识带 capacity() 的容器
+template <typename T>
+size_t heapBytesOf(const T& value) {
+    if constexpr(requires {
+                     typename T::value_type;
+                     value.capacity();
+                 }) {
+        return value.capacity() * sizeof(typename T::value_type);
+    }
+    return 0;
+}
+
+// id 过滤器: id 区间足够稠密时用位图, 否则退化成有序数组上的二分查找
+class IdFilter {
+public:
+    IdFilter() {}
+
+    explicit IdFilter(std::vector<int> ids) : ids(std::move(ids)) {
+        std::sort(this->ids.begin(), this->ids.end());
+        this->ids.erase(std::unique(this->ids.begin(), this->ids.end()), this->ids.end());
+        if(this->ids.empty())
+            return;
+        base = this->ids.front();
+        int64_t range = int64_t(this->ids.back()) - base + 1;
+        if(range > 64 * int64_t(this->ids.size()))
+            return;
+        bits.assign((range + 63) / 64, 0);
+        for(auto id: this->ids) {
+            int64_t offset = int64_t(id) - base;
+            bits[offset >> 6] |= uint64_t(1) << (offset & 63);
+        }
+    }
+
+    [[nodiscard]] bool contains(int id) const {
+        if(bits.empty())
+            return std::binary_search(ids.begin(), ids.end(), id);
+        int64_t offset = int64_t(id) - base;
+        if(offset < 0 || offset >= int64_t(bits.size()) * 64)
+            return false;
+        return (bits[offset >> 6] >> (offset & 63)) & 1;
+    }
+
+    // 有序去重后的 id
+    [[nodiscard]] const std::vector<int>& values() const {
+        return ids;
+    }
+
+private:
+    std::vector<int> ids;
+    int base = 0;
+    std::vector<uint64_t> bits;
+};
+
+template <isVertex V, isDirectedness D>
+class SubgraphView;
+
+// 所有 Graph 特化共用一个计数器
+inline uint64_t nextGraphInstanceId() {
+    static std::atomic<uint64_t> counter = 0;
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+template <isVertex V, isDirectedness D = Directed>
 class Graph {
     template <typename VV>
     struct VertexData {
@@ -139,6 +233,8 @@ class Graph {
     };
 
 public:
+    using VertexTy = V;
+    using DirectednessTy = D;
     using VertexDataTy = typename VertexData<V>::type;
 
     Graph() {};
@@ -147,29 +243,55 @@ public:
 
     Graph(Graph&) = delete;
 
-    virtual void addVertex(const V& v) {
+    void addVertex(const V& v) {
+        mutationEpoch++;
         data.adjMap[v.id];
         data.idToVertex.emplace(v.id, v);
     }
 
-    virtual bool addEdge(const Edge& e) {
+    bool addEdge(const Edge& e) {
+        mutationEpoch++;
         data.adjMap[e.from].insert(e.id);
+        if constexpr(!D::isDirected) {
+            data.adjMap[e.to].insert(e.id);
+        }
         data.idToEdge.emplace(e.id, e);
         return true;
     }
 
-    virtual bool delEdge(int id) {
+    bool delEdge(int id) {
         auto it = data.idToEdge.find(id);
         if(it == data.idToEdge.end())
             return false;
         const auto& edge = it->second;
         if(data.adjMap.count(edge.from))
             data.adjMap[edge.from].erase(id);
+        if constexpr(!D::isDirected) {
+            if(data.adjMap.count(edge.to))
+                data.adjMap[edge.to].erase(id);
+        }
         data.idToEdge.erase(it);
+        mutationEpoch++;
         return true;
     }
 
-    virtual bool delVertex(int id) {
+    bool delVertex(int id) {
+        if constexpr(!D::isDirected) {
+            // 无向图的关联边都在自己的邻接表里, 不需要扫描整张图
+            auto it = data.adjMap.find(id);
+            if(it == data.adjMap.end())
+                return false;
+            mutationEpoch++;
+            for(auto edgeId: it->second) {
+                int other = data.idToEdge.at(edgeId).other(id);
+                if(other != id)
+                    data.adjMap[other].erase(edgeId);
+                data.idToEdge.erase(edgeId);
+            }
+            data.adjMap.erase(it);
+            data.idToVertex.erase(id);
+            return true;
+        }
         bool erased = false;
         auto it = data.adjMap.find(id);
         if(it != data.adjMap.end()) {
@@ -192,6 +314,8 @@ public:
                 erased = true;
             }
         }
+        if(erased)
+            mutationEpoch++;
         return erased;
     }
 
@@ -199,10 +323,20 @@ public:
         return data.adjMap.size();
     }
 
-    [[nodiscard]] virtual int numEdges() const {
+    [[nodiscard]] int numEdges() const {
         return data.idToEdge.size();
     }
 
+    // 每次修改都会增加, 与 instanceId 一起唯一确定图的一个状态
+    [[nodiscard]] uint64_t epoch() const {
+        return mutationEpoch;
+    }
+
+    // 进程内每个 Graph 对象各不相同, 地址被复用也不会重复
+    [[nodiscard]] uint64_t instanceId() const {
+        return instance;
+    }
+
     // getDataOfVertex：仅当 V 不是 Vertex<void> 时可用
     [[nodiscard]] std::expected<const VertexDataTy*, int> getDataOfVertex(int id) const {
         static_assert(!std::is_same_v<V, Vertex<void>>, "Vertex<void> has no data");
@@ -232,6 +366,21 @@ public:
         return vertices;
     }
 
+    // 逐个访问顶点/边, 不产生中间容器
+    template <typename F>
+    void forEachVertex(F&& f) const {
+        for(const auto& [id, vertex]: data.idToVertex) {
+            f(vertex);
+        }
+    }
+
+    template <typename F>
+    void forEachEdge(F&& f) const {
+        for(const auto& [id, edge]: data.idToEdge) {
+            f(edge);
+        }
+    }
+
     GraphData<V> subgraphOfVertices(const std::vector<int>& ids) const {
         auto adjMap = lightSubgraphOfVertices(ids);
         GraphData<V> subData;
@@ -265,14 +414,15 @@ public:
     typename GraphData<V>::AdjMap lightSubgraphOfVertices(const std::vector<int>& ids) const {
         std::unordered_set<int> idSet(ids.begin(), ids.end());
         typename GraphData<V>::AdjMap lightSubMap;
-        for(const auto& [id, edges]: data.adjMap) {
-            if(!idSet.count(id))
+        for(auto id: idSet) {
+            auto it = data.adjMap.find(id);
+            if(it == data.adjMap.end())
                 continue;
-            lightSubMap[id];
-            for(auto eid: edges) {
+            auto& subEdges = lightSubMap[id];
+            for(auto eid: it->second) {
                 const auto& edge = data.idToEdge.at(eid);
-                if(idSet.count(edge.to)) {
-                    lightSubMap[id].insert(eid);
+                if(idSet.count(edge.other(id))) {
+                    subEdges.insert(eid);
                 }
             }
         }
@@ -280,19 +430,38 @@ public:
     }
 
     typename GraphData<V>::AdjMap lightSubgraphOfEdges(const std::vector<int>& ids) const {
-        std::unordered_set<int> idSet(ids.begin(), ids.end());
         typename GraphData<V>::AdjMap lightSubMap;
-        for(const auto& [id, edges]: data.adjMap) {
-            for(auto eid: edges) {
-                if(!idSet.count(eid))
-                    continue;
-                const auto& edge = data.idToEdge.at(eid);
-                lightSubMap[edge.from].insert(eid);
+        for(auto eid: ids) {
+            auto it = data.idToEdge.find(eid);
+            if(it == data.idToEdge.end())
+                continue;
+            const auto& edge = it->second;
+            lightSubMap[edge.from].insert(eid);
+            if constexpr(!D::isDirected) {
+                lightSubMap[edge.to].insert(eid);
             }
         }
         return lightSubMap;
     }
 
+    // 惰性子图: 只记录过滤器, 遍历时直接读原图. 原图被修改或析构后视图失效
+    SubgraphView<V, D> viewOfVertices(const std::vector<int>& ids) const {
+        return SubgraphView<V, D>(*this, IdFilter(ids));
+    }
+
+    SubgraphView<V, D> viewOfEdges(const std::vector<int>& ids) const {
+        std::vector<int> edgeIds, vertexIds;
+        for(auto eid: ids) {
+            auto it = data.idToEdge.find(eid);
+            if(it == data.idToEdge.end())
+                continue;
+            edgeIds.push_back(eid);
+            vertexIds.push_back(it->second.from);
+            vertexIds.push_back(it->second.to);
+        }
+        return SubgraphView<V, D>(*this, IdFilter(std::move(vertexIds)), IdFilter(std::move(edgeIds)));
+    }
+
     const V& getVertex(int id) const {
         return this->data.idToVertex.at(id);
     }
@@ -301,78 +470,300 @@ public:
         return this->data.idToEdge.at(id);
     }
 
+    [[nodiscard]] MemoryUsage memoryUsage() const {
+        MemoryUsage usage;
+        usage.adjacency = hashTableBytes(data.adjMap);
+        for(const auto& [id, edges]: data.adjMap) {
+            usage.adjacency += hashTableBytes(edges);
+        }
+        usage.vertexMap = hashTableBytes(data.idToVertex);
+        usage.edgeMap = hashTableBytes(data.idToEdge);
+        if constexpr(!std::is_void_v<VertexDataTy>) {
+            // 内联在节点里的 data 也记到 vertexData 上
+            usage.vertexMap -= data.idToVertex.size() * sizeof(VertexDataTy);
+            usage.vertexData = data.idToVertex.size() * sizeof(VertexDataTy);
+            for(const auto& [id, vertex]: data.idToVertex) {
+                usage.vertexData += heapBytesOf(vertex.data);
+            }
+        }
+        return usage;
+    }
+
+    // 收缩所有哈希表的桶数组. renumber 为 true 时把顶点和边按原 id 顺序重新编号为
+    // 0..n-1, 返回新 id 到旧 id 的映射, 否则映射为空
+    Renumbering compact(bool renumber = false) {
+        Renumbering mapping;
+        if(renumber) {
+            for(const auto& [id, _]: data.adjMap) {
+                mapping.vertexIds.push_back(id);
+            }
+            for(const auto& [id, edge]: data.idToEdge) {
+                mapping.vertexIds.push_back(edge.to);
+                mapping.edgeIds.push_back(id);
+            }
+            for(const auto& [id, _]: data.idToVertex) {
+                mapping.vertexIds.push_back(id);
+            }
+            std::sort(mapping.vertexIds.begin(), mapping.vertexIds.end());
+            mapping.vertexIds.erase(std::unique(mapping.vertexIds.begin(), mapping.vertexIds.end()),
+                                    mapping.vertexIds.end());
+            std::sort(mapping.edgeIds.begin(), mapping.edgeIds.end());
+            data = renumberedData(std::move(data), mapping);
+            mutationEpoch++;
+            return mapping;
+        }
+        data.adjMap.rehash(0);
+        for(auto& [id, edges]: data.adjMap) {
+            edges.rehash(0);
+        }
+        data.idToVertex.rehash(0);
+        data.idToEdge.rehash(0);
+        return mapping;
+    }
+
+    // 按 mapping 重新编号后的一份拷贝, mapping 必须覆盖所有顶点 (包括边的端点) 和边
+    GraphData<V> relabeled(const Renumbering& mapping) const {
+        return renumberedData(data, mapping);
+    }
+
+    // 补图, 只对无向图有意义
+    GraphData<V> complement() const
+        requires(!D::isDirected)
+    {
+        GraphData<V> graphData;
+        graphData.idToVertex = data.idToVertex;
+        int nextEdgeId = 0;
+        for(const auto& [v, edges]: data.adjMap) {
+            std::unordered_set<int> neighbors;
+            for(auto eid: edges) {
+                neighbors.insert(data.idToEdge.at(eid).other(v));
+            }
+            graphData.adjMap[v];
+            for(const auto& [u, _]: data.adjMap) {
+                if(u <= v || neighbors.count(u))
+                    continue;
+                Edge e(nextEdgeId++, v, u);
+                graphData.adjMap[v].insert(e.id);
+                graphData.adjMap[u].insert(e.id);
+                graphData.idToEdge.emplace(e.id, e);
+            }
+        }
+        return graphData;
+    }
+
 protected:
+    // source 是右值时 vertex data 被移走 (经由 Vertex(int, DataTy) 按值传入后再移入), 否则拷贝
+    template <typename VV>
+    static V withId(VV&& v, int id) {
+        if constexpr(std::is_void_v<VertexDataTy>) {
+            return V(id);
+        } else {
+            return V(id, std::forward<VV>(v).data);
+        }
+    }
+
+    template <typename Data>
+    static GraphData<V> renumberedData(Data&& source, const Renumbering& mapping) {
+        std::unordered_map<int, int> newVertexId, newEdgeId;
+        newVertexId.reserve(mapping.vertexIds.size());
+        newEdgeId.reserve(mapping.edgeIds.size());
+        for(int i = 0; i < mapping.vertexIds.size(); i++) {
+            newVertexId.emplace(mapping.vertexIds[i], i);
+        }
+        for(int i = 0; i < mapping.edgeIds.size(); i++) {
+            newEdgeId.emplace(mapping.edgeIds[i], i);
+        }
+
+        GraphData<V> newData;
+        newData.adjMap.reserve(source.adjMap.size());
+        newData.idToVertex.reserve(source.idToVertex.size());
+        newData.idToEdge.reserve(mapping.edgeIds.size());
+        for(int i = 0; i < mapping.vertexIds.size(); i++) {
+            int oldId = mapping.vertexIds[i];
+            if(auto it = source.adjMap.find(oldId); it != source.adjMap.end()) {
+                auto& edges = newData.adjMap[i];
+                edges.reserve(it->second.size());
+                for(auto eid: it->second) {
+                    edges.insert(newEdgeId.at(eid));
+                }
+            }
+            if(auto it = source.idToVertex.find(oldId); it != source.idToVertex.end()) {
+                if constexpr(std::is_lvalue_reference_v<Data>) {
+                    newData.idToVertex.emplace(i, withId(it->second, i));
+                } else {
+                    newData.idToVertex.emplace(i, withId(std::move(it->second), i));
+                }
+            }
+        }
+        for(int i = 0; i < mapping.edgeIds.size(); i++) {
+            const auto& edge = source.idToEdge.at(mapping.edgeIds[i]);
+            newData.idToEdge.emplace(
+                i, Edge(i, newVertexId.at(edge.from), newVertexId.at(edge.to), edge.weight));
+        }
+        return newData;
+    }
+
     GraphData<V> data;
-    friend std::formatter<GraphLib::Graph<V>>;
+    uint64_t mutationEpoch = 0;
+    const uint64_t instance = nextGraphInstanceId();
+    friend std::formatter<GraphLib::Graph<V, D>>;
+    friend class SubgraphView<V, D>;
 };
 
 template <isVertex V>
-class UndirectedGraph : public Graph<V> {
+using UndirectedGraph = Graph<V, Undirected>;
+
+// 原图上的只读子图, 与 Graph 提供相同的遍历接口, 可直接交给 GraphLib::algorithm
+template <isVertex V, isDirectedness D>
+class SubgraphView {
 public:
-    using Graph<V>::Graph;
-
-    bool addEdge(const Edge& e) override {
-        this->data.adjMap[e.from].insert(e.id);
-        this->data.idToEdge.emplace(e.id, e);
-        Edge revEdge(UndirectedEdgeIdCounter::getPairedId(e.id), e.to, e.from, e.weight);
-        this->data.idToEdge.emplace(revEdge.id, revEdge);
-        this->data.adjMap[e.to].insert(revEdge.id);
-        return true;
+    using VertexTy = V;
+    using DirectednessTy = D;
+    using VertexDataTy = typename Graph<V, D>::VertexDataTy;
+
+    [[nodiscard]] int numVertices() const {
+        return vertexIds.size();
     }
 
-    bool delEdge(int id) override {
-        auto it = this->data.idToEdge.find(id);
-        if(it == this->data.idToEdge.end())
-            return false;
-        const auto& e = it->second;
-        this->data.adjMap[e.from].erase(id);
-        this->data.idToEdge.erase(it);
-        int pairedId = UndirectedEdgeIdCounter::getPairedId(id);
-        auto it2 = this->data.idToEdge.find(pairedId);
-        if(it2 != this->data.idToEdge.end()) {
-            const auto& e2 = it2->second;
-            this->data.adjMap[e2.from].erase(it2->first);
+    // 需要扫描视图内顶点的邻接表, O(视图内的度数之和)
+    [[nodiscard]] int numEdges() const {
+        if(byEdges)
+            return edgeFilter.values().size();
+        int count = 0;
+        forEachEdge([&](const Edge&) { count++; });
+        return count;
+    }
+
+    [[nodiscard]] bool containsVertex(int id) const {
+        return vertexFilter.contains(id);
+    }
+
+    [[nodiscard]] std::expected<const VertexDataTy*, int> getDataOfVertex(int id) const {
+        if(!vertexFilter.contains(id))
+            return std::unexpected(-1);
+        return graph->getDataOfVertex(id);
+    }
+
+    std::expected<std::vector<int>, int> getEdgeIdsOfVertex(int id) const {
+        if(!vertexFilter.contains(id))
+            return std::unexpected(-1);
+        std::vector<int> edgeIds;
+        for(auto eid: edgesOf(id)) {
+            if(keepEdge(graph->getEdge(eid), id))
+                edgeIds.push_back(eid);
         }
-        return true;
+        return edgeIds;
     }
 
-    int numEdges() const override {
-        return this->data.idToEdge.size() / 2;
+    std::vector<V> getAllVertices() const {
+        std::vector<V> vertices;
+        vertices.reserve(vertexIds.size());
+        for(auto id: vertexIds) {
+            vertices.push_back(graph->getVertex(id));
+        }
+        return vertices;
     }
 
-    GraphData<V> complement() const {
-        typename GraphData<V>::AdjMap compMap;
-        GraphData<V> graphData;
-        graphData.idToVertex = this->data.idToVertex;
-        UndirectedEdgeIdCounter idCounter;
-        for(const auto& p: this->data.idToEdge)
-
-            for(const auto& [v, _]: this->data.adjMap) {
-                for(const auto& [u, _2]: this->data.adjMap) {
-                    if(u == v)
-                        continue;
-                    bool connected = false;
-                    for(auto eid: this->data.adjMap.at(v)) {
-                        if(this->data.idToEdge.at(eid).to == u) {
-                            connected = true;
-                            break;
-                        }
-                    }
-                    if(!connected && !compMap[v].count(u)) {
-                        Edge e(idCounter.getNextId(), v, u);
-                        Edge revE(UndirectedEdgeIdCounter::getPairedId(e.id), u, v);
-                        compMap[v].insert(e.id);
-                        compMap[u].insert(e.id);
-                        graphData.idToEdge[e.id] = e;
-                        graphData.idToEdge[revE.id] = revE;
-                    }
-                }
+    template <typename F>
+    void forEachVertex(F&& f) const {
+        for(auto id: vertexIds) {
+            f(graph->getVertex(id));
+        }
+    }
+
+    template <typename F>
+    void forEachEdge(F&& f) const {
+        for(auto id: vertexIds) {
+            for(auto eid: edgesOf(id)) {
+                const auto& edge = graph->getEdge(eid);
+                // 无向边会在两个端点各出现一次, 只在 from 端访问
+                if(keepEdge(edge, id) && (D::isDirected || edge.from == id))
+                    f(edge);
             }
-        graphData.adjMap = std::move(compMap);
-        return graphData;
+        }
+    }
+
+    const V& getVertex(int id) const {
+        return graph->getVertex(id);
     }
 
-    friend std::formatter<GraphLib::Graph<V>>;
+    const Edge& getEdge(int id) const {
+        return graph->getEdge(id);
+    }
+
+    // 真正拷贝出一份子图数据
+    GraphData<V> materialize() const {
+        GraphData<V> subData;
+        for(auto id: vertexIds) {
+            auto& subEdges = subData.adjMap[id];
+            subData.idToVertex.emplace(id, graph->getVertex(id));
+            for(auto eid: edgesOf(id)) {
+                const auto& edge = graph->getEdge(eid);
+                if(!keepEdge(edge, id))
+                    continue;
+                subEdges.insert(eid);
+                subData.idToEdge.emplace(eid, edge);
+            }
+        }
+        return subData;
+    }
+
+private:
+    SubgraphView(const Graph<V, D>& graph, IdFilter vertexFilter) :
+        graph(&graph), vertexFilter(std::move(vertexFilter)) {
+        collectVertexIds();
+    }
+
+    SubgraphView(const Graph<V, D>& graph, IdFilter vertexFilter, IdFilter edgeFilter) :
+        graph(&graph), vertexFilter(std::move(vertexFilter)), edgeFilter(std::move(edgeFilter)),
+        byEdges(true) {
+        collectVertexIds();
+    }
+
+    // 只保留原图中真实存在的顶点. 有向边子图里只作终点的顶点没有邻接表, 按 idToVertex 判断
+    void collectVertexIds() {
+        for(auto id: vertexFilter.values()) {
+            if(graph->data.idToVertex.count(id))
+                vertexIds.push_back(id);
+        }
+        if(vertexIds.size() != vertexFilter.values().size())
+            vertexFilter = IdFilter(vertexIds);
+    }
+
+    const std::unordered_set<int>& edgesOf(int id) const {
+        static const std::unordered_set<int> empty;
+        auto it = graph->data.adjMap.find(id);
+        return it == graph->data.adjMap.end() ? empty : it->second;
+    }
+
+    bool keepEdge(const Edge& edge, int from) const {
+        if(byEdges)
+            return edgeFilter.contains(edge.id);
+        return vertexFilter.contains(edge.other(from));
+    }
+
+    const Graph<V, D>* graph;
+    IdFilter vertexFilter;
+    IdFilter edgeFilter;
+    bool byEdges = false;
+    std::vector<int> vertexIds;
+
+    friend class Graph<V, D>;
+};
+
+// 能被 GraphLib::algorithm 遍历的只读图接口, Graph 与 SubgraphView 都满足
+template <typename G>
+concept isGraphView = requires(const G& g, int id) {
+    typename G::VertexTy;
+    typename G::DirectednessTy;
+    { g.numVertices() } -> std::convertible_to<int>;
+    { g.numEdges() } -> std::convertible_to<int>;
+    { g.getAllVertices() } -> std::same_as<std::vector<typename G::VertexTy>>;
+    { g.getEdgeIdsOfVertex(id) } -> std::same_as<std::expected<std::vector<int>, int>>;
+    { g.getVertex(id) } -> std::same_as<const typename G::VertexTy&>;
+    { g.getEdge(id) } -> std::same_as<const Edge&>;
+    g.forEachVertex([](const typename G::VertexTy&) {});
+    g.forEachEdge([](const Edge&) {});
 };
 
 }  // namespace GraphLib
@@ -464,15 +855,14 @@ struct std::formatter<std::vector<GraphLib::Vertex<T>>> {
     }
 };
 
-template <GraphLib::isVertex V, template <typename VV> class GraphImpl>
-    requires std::is_base_of_v<GraphLib::Graph<V>, GraphImpl<V>>
-struct std::formatter<GraphImpl<V>> {
+template <GraphLib::isVertex V, GraphLib::isDirectedness D>
+struct std::formatter<GraphLib::Graph<V, D>> {
     constexpr auto parse(format_parse_context& ctx) {
         return ctx.begin();
     }
 
     template <typename FormatContext>
-    auto format(const GraphLib::Graph<V>& g, FormatContext& ctx) const {
+    auto format(const GraphLib::Graph<V, D>& g, FormatContext& ctx) const {
         return std::format_to(ctx.out(),
                               "\n\nGraph<{} vertices, {} edges>\nvertices:\n {}\nedges:\n {}\n",
                               g.numVertices(),
@@ -0,0 +1,321 @@
+#pragma once
+
+#include "data.h"
+#include <cerrno>
+#include <charconv>
+#include <concepts>
+#include <cstring>
+#include <expected>
+#include <fcntl.h>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+namespace GraphLib::io {
+
+enum class ExportFormat { EdgeList, Dot, GraphML, Json };
+
+// 写到文件描述符, 处理短写和 EINTR
+struct FdWriter {
+    int fd;
+
+    bool operator() (const char* buf, size_t n) const {
+        while(n > 0) {
+            auto written = ::write(fd, buf, n);
+            if(written < 0) {
+                if(errno == EINTR)
+                    continue;
+                return false;
+            }
+            buf += written;
+            n -= written;
+        }
+        return true;
+    }
+};
+
+struct OstreamWriter {
+    std::ostream& os;
+
+    bool operator() (const char* buf, size_t n) const {
+        os.write(buf, n);
+        return bool(os);
+    }
+};
+
+// 固定大小的输出缓冲, 写满就整块交给 Writer, 导出过程中只占用这一块内存
+template <typename Writer, size_t Capacity = 1 << 16>
+class BufferedSink {
+public:
+    explicit BufferedSink(Writer writer) :
+        writer(std::move(writer)), buffer(std::make_unique<char[]>(Capacity)) {}
+
+    BufferedSink(const BufferedSink&) = delete;
+
+    ~BufferedSink() {
+        flush();
+    }
+
+    void put(char c) {
+        if(size == Capacity)
+            flush();
+        buffer[size++] = c;
+    }
+
+    void write(std::string_view s) {
+        if(s.size() > Capacity - size)
+            flush();
+        if(s.size() >= Capacity) {
+            if(ok)
+                ok = writer(s.data(), s.size());
+            return;
+        }
+        std::memcpy(buffer.get() + size, s.data(), s.size());
+        size += s.size();
+    }
+
+    template <std::integral T>
+    void writeInt(T value) {
+        constexpr size_t maxDigits = 24;
+        if(Capacity - size >= maxDigits) {
+            auto [end, _] = std::to_chars(buffer.get() + size, buffer.get() + Capacity, value);
+            size = end - buffer.get();
+            return;
+        }
+        char tmp[maxDigits];
+        auto [end, _] = std::to_chars(tmp, tmp + maxDigits, value);
+        write(std::string_view(tmp, end - tmp));
+    }
+
+    bool flush() {
+        if(size > 0 && ok)
+            ok = writer(buffer.get(), size);
+        size = 0;
+        return ok;
+    }
+
+    [[nodiscard]] bool good() const {
+        return ok;
+    }
+
+private:
+    Writer writer;
+    std::unique_ptr<char[]> buffer;
+    size_t size = 0;
+    bool ok = true;
+};
+
+enum class Escape { Dot, Xml, Json };
+
+template <typename Sink>
+void writeEscaped(Sink& sink, std::string_view s, Escape escape) {
+    for(char c: s) {
+        switch(escape) {
+            case Escape::Dot:
+                if(c == '"' || c == '\\')
+                    sink.put('\\');
+                sink.put(c);
+                break;
+            case Escape::Xml:
+                switch(c) {
+                    case '<': sink.write("&lt;"); break;
+                    case '>': sink.write("&gt;"); break;
+                    case '&': sink.write("&amp;"); break;
+                    case '"': sink.write("&quot;"); break;
+                    case '\t':
+                    case '\n':
+                    case '\r': sink.put(c); break;
+                    default:
+                        // XML 1.0 连字符引用也不能表示其它控制字符, 换成 U+FFFD
+                        if(static_cast<unsigned char>(c) < 0x20)
+                            sink.write("\xEF\xBF\xBD");
+                        else
+                            sink.put(c);
+                }
+                break;
+            case Escape::Json:
+                if(c == '"' || c == '\\') {
+                    sink.put('\\');
+                    sink.put(c);
+                } else if(static_cast<unsigned char>(c) < 0x20) {
+                    constexpr char hex[] = "0123456789abcdef";
+                    sink.write("\\u00");
+                    sink.put(hex[(c >> 4) & 0xf]);
+                    sink.put(hex[c & 0xf]);
+                } else {
+                    sink.put(c);
+                }
+                break;
+        }
+    }
+}
+
+template <typename V>
+constexpr bool hasVertexData = false;
+
+template <typename DataTy>
+    requires(!std::is_void_v<DataTy>)
+constexpr bool hasVertexData<Vertex<DataTy>> = true;
+
+// 顶点数据通过 std::formatter 格式化到复用的 scratch 里再转义写出
+template <typename Sink, typename V>
+void writeVertexData(Sink& sink, const V& v, Escape escape, std::string& scratch) {
+    if constexpr(hasVertexData<V>) {
+        scratch.clear();
+        std::format_to(std::back_inserter(scratch), "{}", v.data);
+        writeEscaped(sink, scratch, escape);
+    }
+}
+
+// 每行 "from to weight"
+template <isGraphView G, typename Sink>
+void writeEdgeList(const G& graph, Sink& sink) {
+    graph.forEachEdge([&](const Edge& e) {
+        sink.writeInt(e.from);
+        sink.put(' ');
+        sink.writeInt(e.to);
+        sink.put(' ');
+        sink.writeInt(e.weight);
+        sink.put('\n');
+    });
+}
+
+template <isGraphView G, typename Sink>
+void writeDot(const G& graph, Sink& sink) {
+    constexpr bool directed = G::DirectednessTy::isDirected;
+    std::string scratch;
+    sink.write(directed ? "digraph {\n" : "graph {\n");
+    graph.forEachVertex([&](const typename G::VertexTy& v) {
+        sink.write("  ");
+        sink.writeInt(v.id);
+        if constexpr(hasVertexData<typename G::VertexTy>) {
+            sink.write(" [label=\"");
+            writeVertexData(sink, v, Escape::Dot, scratch);
+            sink.write("\"]");
+        }
+        sink.write(";\n");
+    });
+    graph.forEachEdge([&](const Edge& e) {
+        sink.write("  ");
+        sink.writeInt(e.from);
+        sink.write(directed ? " -> " : " -- ");
+        sink.writeInt(e.to);
+        sink.write(" [id=");
+        sink.writeInt(e.id);
+        sink.write(", weight=");
+        sink.writeInt(e.weight);
+        sink.write("];\n");
+    });
+    sink.write("}\n");
+}
+
+template <isGraphView G, typename Sink>
+void writeGraphML(const G& graph, Sink& sink) {
+    std::string scratch;
+    sink.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+               "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n");
+    if constexpr(hasVertexData<typename G::VertexTy>) {
+        sink.write("  <key id=\"data\" for=\"node\" attr.name=\"data\" attr.type=\"string\"/>\n");
+    }
+    sink.write("  <key id=\"weight\" for=\"edge\" attr.name=\"weight\" attr.type=\"int\"/>\n");
+    sink.write(G::DirectednessTy::isDirected ? "  <graph id=\"G\" edgedefault=\"directed\">\n"
+                                             : "  <graph id=\"G\" edgedefault=\"undirected\">\n");
+    graph.forEachVertex([&](const typename G::VertexTy& v) {
+        sink.write("    <node id=\"n");
+        sink.writeInt(v.id);
+        if constexpr(hasVertexData<typename G::VertexTy>) {
+            sink.write("\"><data key=\"data\">");
+            writeVertexData(sink, v, Escape::Xml, scratch);
+            sink.write("</data></node>\n");
+        } else {
+            sink.write("\"/>\n");
+        }
+    });
+    graph.forEachEdge([&](const Edge& e) {
+        sink.write("    <edge id=\"e");
+        sink.writeInt(e.id);
+        sink.write("\" source=\"n");
+        sink.writeInt(e.from);
+        sink.write("\" target=\"n");
+        sink.writeInt(e.to);
+        sink.write("\"><data key=\"weight\">");
+        sink.writeInt(e.weight);
+        sink.write("</data></edge>\n");
+    });
+    sink.write("  </graph>\n</graphml>\n");
+}
+
+template <isGraphView G, typename Sink>
+void writeJson(const G& graph, Sink& sink) {
+    std::string scratch;
+    bool first = true;
+    sink.write(G::DirectednessTy::isDirected ? "{\"directed\":true,\"vertices\":["
+                                             : "{\"directed\":false,\"vertices\":[");
+    graph.forEachVertex([&](const typename G::VertexTy& v) {
+        if(!first)
+            sink.put(',');
+        first = false;
+        sink.write("{\"id\":");
+        sink.writeInt(v.id);
+        if constexpr(hasVertexData<typename G::VertexTy>) {
+            sink.write(",\"data\":\"");
+            writeVertexData(sink, v, Escape::Json, scratch);
+            sink.put('"');
+        }
+        sink.put('}');
+    });
+    sink.write("],\"edges\":[");
+    first = true;
+    graph.forEachEdge([&](const Edge& e) {
+        if(!first)
+            sink.put(',');
+        first = false;
+        sink.write("{\"id\":");
+        sink.writeInt(e.id);
+        sink.write(",\"from\":");
+        sink.writeInt(e.from);
+        sink.write(",\"to\":");
+        sink.writeInt(e.to);
+        sink.write(",\"weight\":");
+        sink.writeInt(e.weight);
+        sink.put('}');
+    });
+    sink.write("]}\n");
+}
+
+template <isGraphView G, typename Sink>
+void write(const G& graph, Sink& sink, ExportFormat format) {
+    switch(format) {
+        case ExportFormat::EdgeList: writeEdgeList(graph, sink); break;
+        case ExportFormat::Dot: writeDot(graph, sink); break;
+        case ExportFormat::GraphML: writeGraphML(graph, sink); break;
+        case ExportFormat::Json: writeJson(graph, sink); break;
+    }
+}
+
+// 失败时返回 errno
+template <isGraphView G>
+std::expected<void, int> exportToFile(const G& graph, const std::string& path, ExportFormat format) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+        return std::unexpected(errno);
+    bool ok;
+    {
+        BufferedSink<FdWriter> sink(FdWriter{fd});
+        write(graph, sink, format);
+        ok = sink.flush();
+    }
+    int err = ok ? 0 : errno;
+    if(::close(fd) != 0 && ok) {
+        ok = false;
+        err = errno;
+    }
+    if(!ok)
+        return std::unexpected(err);
+    return {};
+}
+
+}  // namespace GraphLib::io
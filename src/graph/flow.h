@@ -0,0 +1,546 @@
+#pragma once
+
+#include "data.h"
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace GraphLib::algorithm {
+
+// 残量网络的布局: 顶点按 id 排序后编号, 弧按起点连续存放, 每条弧与反向弧成对,
+// reverse[a] 是 a 的反向弧. 有向边 u -> v 得到容量为 weight 的 u -> v 和容量为 0 的 v -> u,
+// 无向边两个方向的容量都是 weight. 网络本身只读, 求解时复制一份残量, 同一个网络可以反复求解
+struct FlowNetwork {
+    std::vector<int> ids;
+    std::unordered_map<int, int> idToIndex;
+    std::vector<int> offsets;  // size n + 1
+    std::vector<int> heads;
+    std::vector<int> reverse;
+    std::vector<int> edgeIds;
+    std::vector<int64_t> capacity;
+
+    [[nodiscard]] int numVertices() const {
+        return ids.size();
+    }
+
+    [[nodiscard]] int numArcs() const {
+        return heads.size();
+    }
+
+    // 不存在时返回 -1
+    [[nodiscard]] int indexOf(int id) const {
+        auto it = idToIndex.find(id);
+        return it == idToIndex.end() ? -1 : it->second;
+    }
+};
+
+struct MaxFlowResult {
+    int64_t flow = 0;
+    std::vector<int> sourceSide;  // 最小割中源点一侧的顶点 id, 按 id 排序
+    std::vector<int> cutEdges;    // 从源点一侧指向汇点一侧的边 id, 按 id 排序
+};
+
+// 忽略自环, 与 toCsr 一样只保留两端都在图中的边 (addEdge 不要求端点已经加入). 容量为负时抛异常
+template <isGraphView G>
+FlowNetwork toFlowNetwork(const G& graph) {
+    constexpr bool directed = G::DirectednessTy::isDirected;
+    FlowNetwork network;
+    graph.forEachVertex([&](const typename G::VertexTy& v) { network.ids.push_back(v.id); });
+    std::sort(network.ids.begin(), network.ids.end());
+    const int n = network.ids.size();
+    network.idToIndex.reserve(n);
+    for(int i = 0; i < n; i++) {
+        network.idToIndex.emplace(network.ids[i], i);
+    }
+    network.offsets.assign(n + 1, 0);
+    graph.forEachEdge([&](const Edge& edge) {
+        if(edge.weight < 0)
+            throw std::runtime_error("Negative capacity");
+        const int u = network.indexOf(edge.from), v = network.indexOf(edge.to);
+        if(u >= 0 && v >= 0 && u != v) {
+            network.offsets[u + 1]++;
+            network.offsets[v + 1]++;
+        }
+    });
+    for(int v = 0; v < n; v++) {
+        network.offsets[v + 1] += network.offsets[v];
+    }
+    const int m = network.offsets[n];
+    network.heads.resize(m);
+    network.reverse.resize(m);
+    network.edgeIds.resize(m);
+    network.capacity.resize(m);
+    std::vector<int> fill(network.offsets.begin(), network.offsets.end() - 1);
+    graph.forEachEdge([&](const Edge& edge) {
+        const int u = network.indexOf(edge.from), v = network.indexOf(edge.to);
+        if(u < 0 || v < 0 || u == v)
+            return;
+        const int a = fill[u]++, b = fill[v]++;
+        network.heads[a] = v;
+        network.heads[b] = u;
+        network.reverse[a] = b;
+        network.reverse[b] = a;
+        network.edgeIds[a] = network.edgeIds[b] = edge.id;
+        network.capacity[a] = edge.weight;
+        network.capacity[b] = directed ? 0 : edge.weight;
+    });
+    return network;
+}
+
+// 构建只是两次线性扫描, 任何策略都顺序执行
+template <execution::isExecutionPolicy P, isGraphView G>
+FlowNetwork toFlowNetwork(const P&, const G& graph) {
+    return toFlowNetwork(graph);
+}
+
+namespace detail {
+
+    inline std::pair<int, int> flowEndpoints(const FlowNetwork& network, int source, int sink) {
+        const int s = network.indexOf(source), t = network.indexOf(sink);
+        if(s < 0 || t < 0)
+            throw std::runtime_error("Source or sink not in graph");
+        if(s == t)
+            throw std::runtime_error("Source and sink are the same vertex");
+        return {s, t};
+    }
+
+    // 在残量网络里从 t 反向 BFS, dist[v] 为 v 到 t 的残量距离, 到不了的保持 unreached.
+    // skip 不入队 (推流算法里的源点)
+    inline void reverseResidualBfs(const FlowNetwork& network,
+                                   const std::vector<int64_t>& residual,
+                                   int t,
+                                   int skip,
+                                   std::vector<int>& dist,
+                                   int unreached) {
+        std::fill(dist.begin(), dist.end(), unreached);
+        std::vector<int> queue{t};
+        dist[t] = 0;
+        for(int head = 0; head < queue.size(); head++) {
+            const int w = queue[head];
+            for(int a = network.offsets[w]; a < network.offsets[w + 1]; a++) {
+                const int v = network.heads[a];
+                if(v != skip && dist[v] == unreached && residual[network.reverse[a]] > 0) {
+                    dist[v] = dist[w] + 1;
+                    queue.push_back(v);
+                }
+            }
+        }
+    }
+
+    // 残量网络中到不了汇点的顶点构成源点一侧, 这是汇点一侧最小的那个最小割
+    inline void fillMinCut(const FlowNetwork& network,
+                           const std::vector<int64_t>& residual,
+                           int t,
+                           MaxFlowResult& result) {
+        const int n = network.numVertices();
+        std::vector<int> dist(n);
+        reverseResidualBfs(network, residual, t, -1, dist, -1);
+        for(int v = 0; v < n; v++) {
+            if(dist[v] >= 0)
+                continue;
+            result.sourceSide.push_back(network.ids[v]);
+            for(int a = network.offsets[v]; a < network.offsets[v + 1]; a++) {
+                if(network.capacity[a] > 0 && dist[network.heads[a]] >= 0)
+                    result.cutEdges.push_back(network.edgeIds[a]);
+            }
+        }
+        std::sort(result.cutEdges.begin(), result.cutEdges.end());
+    }
+
+    // 最高标号推流-重标号, 只做第一阶段 (求出最大预流): 流量值和最小割此时已经确定.
+    // 按标号分桶: active 存活跃顶点, all 是同一标号全部顶点的双向链表, 用于间隙优化
+    class PushRelabel {
+    public:
+        PushRelabel(const FlowNetwork& network, int s, int t) :
+            network(network), n(network.numVertices()), s(s), t(t), residual(network.capacity),
+            label(n), cur(n), excess(n, 0), active(n), allHead(n, -1), allNext(n), allPrev(n) {}
+
+        int64_t run() {
+            label[s] = n;
+            for(int a = network.offsets[s]; a < network.offsets[s + 1]; a++) {
+                const int w = network.heads[a];
+                excess[w] += residual[a];
+                residual[network.reverse[a]] += residual[a];
+                residual[a] = 0;
+            }
+            globalRelabel();
+            const int64_t relabelBudget = 6 * int64_t(n) + network.numArcs() / 2;
+            while(maxActive >= 0) {
+                if(active[maxActive].empty()) {
+                    maxActive--;
+                    continue;
+                }
+                const int v = active[maxActive].back();
+                active[maxActive].pop_back();
+                discharge(v);
+                if(work > relabelBudget)
+                    globalRelabel();
+            }
+            return excess[t];
+        }
+
+        [[nodiscard]] const std::vector<int64_t>& residualCapacity() const {
+            return residual;
+        }
+
+    private:
+        const FlowNetwork& network;
+        const int n, s, t;
+        std::vector<int64_t> residual;
+        std::vector<int> label, cur;
+        std::vector<int64_t> excess;
+        std::vector<std::vector<int>> active;
+        std::vector<int> allHead, allNext, allPrev;
+        int maxActive = -1, maxLabel = -1;
+        int64_t work = 0;
+
+        void link(int v) {
+            const int l = label[v];
+            allPrev[v] = -1;
+            allNext[v] = allHead[l];
+            if(allHead[l] >= 0)
+                allPrev[allHead[l]] = v;
+            allHead[l] = v;
+            maxLabel = std::max(maxLabel, l);
+        }
+
+        void unlink(int v) {
+            const int l = label[v];
+            if(allPrev[v] >= 0)
+                allNext[allPrev[v]] = allNext[v];
+            else
+                allHead[l] = allNext[v];
+            if(allNext[v] >= 0)
+                allPrev[allNext[v]] = allPrev[v];
+        }
+
+        // 用到汇点的残量距离重算所有标号, 到不了的置为 n 不再处理
+        void globalRelabel() {
+            reverseResidualBfs(network, residual, t, s, label, n);
+            label[s] = n;
+            std::fill(allHead.begin(), allHead.end(), -1);
+            for(auto& bucket: active) {
+                bucket.clear();
+            }
+            maxActive = maxLabel = -1;
+            for(int v = 0; v < n; v++) {
+                cur[v] = network.offsets[v];
+                if(label[v] >= n)
+                    continue;
+                link(v);
+                if(v != t && excess[v] > 0) {
+                    active[label[v]].push_back(v);
+                    maxActive = std::max(maxActive, label[v]);
+                }
+            }
+            work = 0;
+        }
+
+        void push(int v, int a) {
+            const int w = network.heads[a];
+            const int64_t delta = std::min(excess[v], residual[a]);
+            residual[a] -= delta;
+            residual[network.reverse[a]] += delta;
+            // v 可能刚被重标号过, w 所在的桶可以高于 maxActive
+            if(w != t && excess[w] == 0) {
+                active[label[w]].push_back(w);
+                maxActive = std::max(maxActive, label[w]);
+            }
+            excess[w] += delta;
+            excess[v] -= delta;
+        }
+
+        // 标号 l 的桶空了: 标号高于 l 的顶点都到不了汇点
+        void gap(int l) {
+            for(int k = l + 1; k <= maxLabel; k++) {
+                for(int v = allHead[k]; v >= 0; v = allNext[v]) {
+                    label[v] = n;
+                }
+                allHead[k] = -1;
+                active[k].clear();
+            }
+            maxLabel = l - 1;
+        }
+
+        void discharge(int v) {
+            while(true) {
+                const int l = label[v];
+                const int end = network.offsets[v + 1];
+                for(; cur[v] < end; cur[v]++) {
+                    const int a = cur[v];
+                    if(residual[a] > 0 && label[network.heads[a]] == l - 1) {
+                        push(v, a);
+                        if(excess[v] == 0)
+                            return;
+                    }
+                }
+                // 重标号
+                unlink(v);
+                if(allHead[l] < 0) {
+                    gap(l);
+                    label[v] = n;
+                    return;
+                }
+                int next = n;
+                for(int a = network.offsets[v]; a < end; a++) {
+                    if(residual[a] > 0 && label[network.heads[a]] + 1 < next) {
+                        next = label[network.heads[a]] + 1;
+                        cur[v] = a;
+                    }
+                }
+                work += end - network.offsets[v] + 12;
+                label[v] = next;
+                if(next >= n)
+                    return;
+                link(v);
+            }
+        }
+    };
+
+}  // namespace detail
+
+// Dinic 算法, 分层图上用当前弧和显式栈找阻塞流. 单位容量或很小的网络上常常更快
+inline MaxFlowResult dinicMaxFlow(const FlowNetwork& network, int source, int sink) {
+    auto [s, t] = detail::flowEndpoints(network, source, sink);
+    const int n = network.numVertices();
+    std::vector<int64_t> residual = network.capacity;
+    std::vector<int> level(n), cur(n), path;
+    MaxFlowResult result;
+    while(true) {
+        std::fill(level.begin(), level.end(), -1);
+        std::vector<int> queue{s};
+        level[s] = 0;
+        for(int head = 0; head < queue.size(); head++) {
+            const int v = queue[head];
+            for(int a = network.offsets[v]; a < network.offsets[v + 1]; a++) {
+                const int w = network.heads[a];
+                if(residual[a] > 0 && level[w] < 0) {
+                    level[w] = level[v] + 1;
+                    queue.push_back(w);
+                }
+            }
+        }
+        if(level[t] < 0)
+            break;
+        std::copy(network.offsets.begin(), network.offsets.end() - 1, cur.begin());
+        path.clear();
+        int v = s;
+        while(true) {
+            if(v == t) {
+                int64_t bottleneck = std::numeric_limits<int64_t>::max();
+                for(int a: path) {
+                    bottleneck = std::min(bottleneck, residual[a]);
+                }
+                int firstSaturated = -1;
+                for(int i = 0; i < path.size(); i++) {
+                    residual[path[i]] -= bottleneck;
+                    residual[network.reverse[path[i]]] += bottleneck;
+                    if(firstSaturated < 0 && residual[path[i]] == 0)
+                        firstSaturated = i;
+                }
+                result.flow += bottleneck;
+                // 退回到第一条饱和弧的起点继续找
+                path.resize(firstSaturated);
+                v = path.empty() ? s : network.heads[path.back()];
+                continue;
+            }
+            const int end = network.offsets[v + 1];
+            while(cur[v] < end
+                  && (residual[cur[v]] == 0 || level[network.heads[cur[v]]] != level[v] + 1)) {
+                cur[v]++;
+            }
+            if(cur[v] < end) {
+                path.push_back(cur[v]);
+                v = network.heads[cur[v]];
+                continue;
+            }
+            // 死路, 以后不再进入 v
+            level[v] = -1;
+            if(path.empty())
+                break;
+            v = network.heads[network.reverse[path.back()]];
+            path.pop_back();
+            cur[v]++;
+        }
+    }
+    detail::fillMinCut(network, residual, t, result);
+    return result;
+}
+
+// 容量为边的 weight. seq 时是最高标号选择的推流-重标号 (间隙与全局重标号优化).
+// 并行时是同步的推流-重标号, 面向大网络, 每一轮:
+// 1. 所有活跃顶点按上一轮的标号并行推流, 收到的超额先记在原子增量里;
+// 2. 还有超额的顶点并行计算新标号, 写入单独的数组;
+// 3. 统一生效. 推流只沿 label[v] == label[w] + 1 的弧, 一条弧和它的反向弧同一轮内只会被一端改写.
+// 累计的重标号工作量足够多时做一次并行的全局重标号
+template <execution::isExecutionPolicy P>
+MaxFlowResult pushRelabelMaxFlow(const P& policy, const FlowNetwork& network, int source, int sink) {
+    auto [s, t] = detail::flowEndpoints(network, source, sink);
+    if constexpr(execution::isSequenced<P>) {
+        detail::PushRelabel solver(network, s, t);
+        MaxFlowResult result;
+        result.flow = solver.run();
+        detail::fillMinCut(network, solver.residualCapacity(), t, result);
+        return result;
+    } else {
+        const int n = network.numVertices();
+        const int blocks = parallel::concurrency(policy);
+        std::vector<int64_t> residual = network.capacity;
+        std::vector<int> label(n), newLabel(n);
+        std::vector<int64_t> excess(n, 0);
+        std::vector<std::atomic<int64_t>> added(n);
+        std::vector<std::atomic<char>> seen(n);
+        std::vector<char> queued(n, false);
+        std::vector<std::vector<int>> parts(blocks);
+
+        for(int a = network.offsets[s]; a < network.offsets[s + 1]; a++) {
+            excess[network.heads[a]] += residual[a];
+            residual[network.reverse[a]] += residual[a];
+            residual[a] = 0;
+        }
+
+        // 逐层并行的反向 BFS, 每个顶点由发现它的线程写标号
+        auto globalRelabel = [&] {
+            parallel::parallelFor(policy, 0, n, [&](int lo, int hi) {
+                for(int v = lo; v < hi; v++) {
+                    seen[v].store(v == t || v == s, std::memory_order_relaxed);
+                    label[v] = n;
+                }
+            });
+            label[t] = 0;
+            std::vector<int> frontier{t};
+            for(int depth = 1; !frontier.empty(); depth++) {
+                parallel::forBlocks(policy, 0, frontier.size(), [&](int b, int lo, int hi) {
+                    for(int i = lo; i < hi; i++) {
+                        const int w = frontier[i];
+                        for(int a = network.offsets[w]; a < network.offsets[w + 1]; a++) {
+                            const int v = network.heads[a];
+                            if(residual[network.reverse[a]] > 0
+                               && !seen[v].load(std::memory_order_relaxed)
+                               && !seen[v].exchange(1, std::memory_order_relaxed)) {
+                                label[v] = depth;
+                                parts[b].push_back(v);
+                            }
+                        }
+                    }
+                });
+                frontier.clear();
+                for(auto& part: parts) {
+                    frontier.insert(frontier.end(), part.begin(), part.end());
+                    part.clear();
+                }
+            }
+        };
+
+        globalRelabel();
+        std::vector<int> activeList;
+        for(int v = 0; v < n; v++) {
+            if(v != t && v != s && excess[v] > 0 && label[v] < n)
+                activeList.push_back(v);
+        }
+        const int64_t relabelBudget = 6 * int64_t(n) + network.numArcs() / 2;
+        int64_t work = 0;
+        std::vector<int64_t> blockWork(blocks);
+        while(!activeList.empty()) {
+            parallel::forBlocks(policy, 0, activeList.size(), [&](int b, int lo, int hi) {
+                for(int i = lo; i < hi; i++) {
+                    const int v = activeList[i];
+                    const int last = network.offsets[v + 1];
+                    for(int a = network.offsets[v]; a < last && excess[v] > 0; a++) {
+                        const int w = network.heads[a];
+                        if(label[w] != label[v] - 1 || residual[a] == 0)
+                            continue;
+                        const int64_t delta = std::min(excess[v], residual[a]);
+                        residual[a] -= delta;
+                        residual[network.reverse[a]] += delta;
+                        excess[v] -= delta;
+                        if(added[w].fetch_add(delta, std::memory_order_relaxed) == 0)
+                            parts[b].push_back(w);
+                    }
+                }
+            });
+            parallel::forBlocks(policy, 0, activeList.size(), [&](int b, int lo, int hi) {
+                for(int i = lo; i < hi; i++) {
+                    const int v = activeList[i];
+                    newLabel[v] = label[v];
+                    if(excess[v] == 0)
+                        continue;
+                    int next = n;
+                    for(int a = network.offsets[v]; a < network.offsets[v + 1]; a++) {
+                        if(residual[a] > 0)
+                            next = std::min(next, label[network.heads[a]] + 1);
+                    }
+                    newLabel[v] = next;
+                    blockWork[b] += network.offsets[v + 1] - network.offsets[v] + 12;
+                }
+            });
+            std::vector<int> nextActive;
+            for(int v: activeList) {
+                label[v] = newLabel[v];
+                if(excess[v] > 0 && label[v] < n && !queued[v]) {
+                    queued[v] = true;
+                    nextActive.push_back(v);
+                }
+            }
+            for(auto& part: parts) {
+                for(int w: part) {
+                    excess[w] += added[w].exchange(0, std::memory_order_relaxed);
+                    if(w != t && w != s && label[w] < n && !queued[w]) {
+                        queued[w] = true;
+                        nextActive.push_back(w);
+                    }
+                }
+                part.clear();
+            }
+            for(auto& value: blockWork) {
+                work += value;
+                value = 0;
+            }
+            if(work > relabelBudget) {
+                globalRelabel();
+                work = 0;
+                std::erase_if(nextActive, [&](int v) {
+                    queued[v] = label[v] < n;
+                    return !queued[v];
+                });
+            }
+            for(int v: nextActive) {
+                queued[v] = false;
+            }
+            activeList.swap(nextActive);
+        }
+
+        MaxFlowResult result;
+        result.flow = excess[t];
+        detail::fillMinCut(network, residual, t, result);
+        return result;
+    }
+}
+
+// Dinic 的阶段之间相互依赖, 没有并行版本, 任何策略都顺序执行
+template <execution::isExecutionPolicy P>
+MaxFlowResult dinicMaxFlow(const P&, const FlowNetwork& network, int source, int sink) {
+    return dinicMaxFlow(network, source, sink);
+}
+
+inline MaxFlowResult pushRelabelMaxFlow(const FlowNetwork& network, int source, int sink) {
+    return pushRelabelMaxFlow(execution::seq, network, source, sink);
+}
+
+// 默认的引擎: 推流-重标号
+template <execution::isExecutionPolicy P, isGraphView G>
+MaxFlowResult maxFlow(const P& policy, const G& graph, int source, int sink) {
+    return pushRelabelMaxFlow(policy, toFlowNetwork(graph), source, sink);
+}
+
+template <isGraphView G>
+MaxFlowResult maxFlow(const G& graph, int source, int sink) {
+    return maxFlow(execution::seq, graph, source, sink);
+}
+
+}  // namespace GraphLib::algorithm
@@ -0,0 +1,133 @@
+#pragma once
+
+#if __has_include(<generator>)
+#include <generator>
+#endif
+
+#if defined(__cpp_lib_generator) && __cpp_lib_generator >= 202207L
+
+namespace GraphLib {
+
+template <typename T>
+using Generator = std::generator<T>;
+
+}  // namespace GraphLib
+
+#else
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace GraphLib {
+
+// 标准库还没有 std::generator 时的最小替代: 惰性的单次输入范围, 迭代时按值读取
+template <typename T>
+class Generator {
+public:
+    struct promise_type {
+        const T* current = nullptr;
+        std::exception_ptr exception;
+
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        // co_yield 的临时对象会一直活到协程恢复
+        std::suspend_always yield_value(const T& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+
+        void return_void() {}
+
+        void unhandled_exception() {
+            exception = std::current_exception();
+        }
+
+        template <typename U>
+        std::suspend_never await_transform(U&&) = delete;
+    };
+
+    class iterator {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() {}
+
+        explicit iterator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+        const T& operator* () const {
+            return *handle.promise().current;
+        }
+
+        iterator& operator++ () {
+            resume(handle);
+            return *this;
+        }
+
+        void operator++ (int) {
+            ++*this;
+        }
+
+        bool operator== (std::default_sentinel_t) const {
+            return !handle || handle.done();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    Generator(Generator&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+
+    Generator& operator= (Generator&& other) noexcept {
+        if(this != &other) {
+            if(handle)
+                handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+
+    ~Generator() {
+        if(handle)
+            handle.destroy();
+    }
+
+    iterator begin() {
+        resume(handle);
+        return iterator(handle);
+    }
+
+    std::default_sentinel_t end() const noexcept {
+        return {};
+    }
+
+private:
+    explicit Generator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    static void resume(std::coroutine_handle<promise_type> handle) {
+        handle.resume();
+        if(auto exception = handle.promise().exception) {
+            handle.promise().exception = nullptr;
+            std::rethrow_exception(exception);
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+}  // namespace GraphLib
+
+#endif
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "csr.h"
+#include "data.h"
+#include "parallel.h"
+#include <atomic>
+#include <vector>
+
+namespace GraphLib::algorithm {
+
+// 有向图按忽略方向后的简单图计算
+struct CoreDecomposition {
+    std::vector<int> ids;       // 按 id 排序
+    std::vector<int> coreness;  // 与 ids 一一对应
+    std::vector<int> order;     // 退化序 (剥离顺序), 存顶点 id
+    int degeneracy = 0;
+
+    // 不存在时返回 -1
+    [[nodiscard]] int corenessOf(int id) const {
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if(it == ids.end() || *it != id)
+            return -1;
+        return coreness[it - ids.begin()];
+    }
+};
+
+// Batagelj-Zaversnik 桶排序剥离, O(V + E)
+template <isGraphView G>
+CoreDecomposition coreDecomposition(const G& graph) {
+    const CsrGraph adj = simpleUndirected(toCsr(graph));
+    const int n = adj.numVertices();
+    CoreDecomposition result;
+    result.ids = adj.ids;
+    result.coreness.resize(n);
+    result.order.reserve(n);
+
+    std::vector<int> deg(n), pos(n), vert(n);
+    int maxDeg = 0;
+    for(int v = 0; v < n; v++) {
+        deg[v] = adj.degree(v);
+        maxDeg = std::max(maxDeg, deg[v]);
+    }
+    // bin[d]: 度数为 d 的顶点在 vert 中的起始位置
+    std::vector<int> bin(maxDeg + 2, 0);
+    for(int v = 0; v < n; v++) {
+        bin[deg[v] + 1]++;
+    }
+    for(int d = 0; d <= maxDeg; d++) {
+        bin[d + 1] += bin[d];
+    }
+    for(int v = 0; v < n; v++) {
+        pos[v] = bin[deg[v]]++;
+        vert[pos[v]] = v;
+    }
+    for(int d = maxDeg; d > 0; d--) {
+        bin[d] = bin[d - 1];
+    }
+    bin[0] = 0;
+
+    for(int i = 0; i < n; i++) {
+        int v = vert[i];
+        result.coreness[v] = deg[v];
+        result.order.push_back(adj.ids[v]);
+        for(int u: adj.neighbors(v)) {
+            if(deg[u] <= deg[v])
+                continue;
+            // 把 u 换到它所在桶的开头, 再把桶的边界右移, u 就落进了低一级的桶
+            int du = deg[u], pu = pos[u], pw = bin[du], w = vert[pw];
+            if(u != w) {
+                pos[u] = pw;
+                vert[pw] = u;
+                pos[w] = pu;
+                vert[pu] = w;
+            }
+            bin[du]++;
+            deg[u]--;
+        }
+    }
+    for(int c: result.coreness) {
+        result.degeneracy = std::max(result.degeneracy, c);
+    }
+    return result;
+}
+
+// seq 时用上面的 Batagelj-Zaversnik 算法. 并行时按层同步剥离: 第 k 层反复并行删除度数
+// 不超过 k 的顶点, 每个被删除的顶点并行地给还活着的邻居减度数, 恰好降到 k 的邻居进入下一批
+template <execution::isExecutionPolicy P, isGraphView G>
+CoreDecomposition coreDecomposition(const P& policy, const G& graph) {
+    if constexpr(execution::isSequenced<P>) {
+        return coreDecomposition(graph);
+    } else {
+        const CsrGraph adj = simpleUndirected(toCsr(graph));
+        const int n = adj.numVertices();
+        CoreDecomposition result;
+        result.ids = adj.ids;
+        result.coreness.resize(n);
+        result.order.reserve(n);
+
+        std::vector<std::atomic<int>> deg(n);
+        std::vector<char> removed(n, false);
+        parallel::parallelFor(policy, 0, n, [&](int lo, int hi) {
+            for(int v = lo; v < hi; v++) {
+                deg[v].store(adj.degree(v), std::memory_order_relaxed);
+            }
+        });
+
+        // 并行收集还活着且度数不超过 k 的顶点, 每块写自己的 nextParts[b]
+        std::vector<std::vector<int>> nextParts(parallel::concurrency(policy));
+        auto collect = [&](int k, std::vector<int>& frontier) {
+            parallel::forBlocks(policy, 0, n, [&](int b, int lo, int hi) {
+                for(int v = lo; v < hi; v++) {
+                    if(!removed[v] && deg[v].load(std::memory_order_relaxed) <= k)
+                        nextParts[b].push_back(v);
+                }
+            });
+            for(auto& next: nextParts) {
+                frontier.insert(frontier.end(), next.begin(), next.end());
+                next.clear();
+            }
+        };
+
+        int remaining = n;
+        int k = 0;
+        std::vector<int> frontier;
+        while(remaining > 0) {
+            collect(k, frontier);
+            if(frontier.empty()) {
+                // 剩下的顶点度数都大于 k, 直接跳到最小度数那一层
+                k = parallel::parallelReduce(
+                    policy, 0, n, n,
+                    [&](int lo, int hi) {
+                        int m = n;
+                        for(int v = lo; v < hi; v++) {
+                            if(!removed[v])
+                                m = std::min(m, deg[v].load(std::memory_order_relaxed));
+                        }
+                        return m;
+                    },
+                    [](int a, int b) { return std::min(a, b); });
+                continue;
+            }
+            while(!frontier.empty()) {
+                for(int v: frontier) {
+                    removed[v] = true;
+                    result.coreness[v] = k;
+                    result.order.push_back(adj.ids[v]);
+                }
+                remaining -= frontier.size();
+                parallel::forBlocks(policy, 0, frontier.size(), [&](int b, int lo, int hi) {
+                    auto& next = nextParts[b];
+                    for(int i = lo; i < hi; i++) {
+                        for(int u: adj.neighbors(frontier[i])) {
+                            if(removed[u])
+                                continue;
+                            if(deg[u].fetch_sub(1, std::memory_order_relaxed) == k + 1)
+                                next.push_back(u);
+                        }
+                    }
+                });
+                frontier.clear();
+                for(auto& next: nextParts) {
+                    frontier.insert(frontier.end(), next.begin(), next.end());
+                    next.clear();
+                }
+            }
+            result.degeneracy = k;
+        }
+        return result;
+    }
+}
+
+// k-core 的惰性子图视图
+template <isVertex V, isDirectedness D>
+SubgraphView<V, D> kCore(const Graph<V, D>& graph, const CoreDecomposition& cores, int k) {
+    std::vector<int> ids;
+    for(int i = 0; i < cores.ids.size(); i++) {
+        if(cores.coreness[i] >= k)
+            ids.push_back(cores.ids[i]);
+    }
+    return graph.viewOfVertices(ids);
+}
+
+// 只是按已有的分解筛选顶点, 任何策略都顺序执行
+template <execution::isExecutionPolicy P, isVertex V, isDirectedness D>
+SubgraphView<V, D> kCore(const P&, const Graph<V, D>& graph, const CoreDecomposition& cores, int k) {
+    return kCore(graph, cores, k);
+}
+
+template <execution::isExecutionPolicy P, isVertex V, isDirectedness D>
+SubgraphView<V, D> kCore(const P& policy, const Graph<V, D>& graph, int k) {
+    return kCore(graph, coreDecomposition(policy, graph), k);
+}
+
+template <isVertex V, isDirectedness D>
+SubgraphView<V, D> kCore(const Graph<V, D>& graph, int k) {
+    return kCore(execution::seq, graph, k);
+}
+
+}  // namespace GraphLib::algorithm
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "csr.h"
+#include "data.h"
+#include "parallel.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace GraphLib::algorithm {
+
+// 行是源点, 列是 ids 中的顶点, 不可达为 -1
+struct DistanceMatrix {
+    std::vector<int> ids;  // 按 id 排序
+    std::vector<int> sources;
+    std::vector<int> dist;
+
+    [[nodiscard]] int at(int sourceIndex, int vertexIndex) const {
+        return dist[size_t(sourceIndex) * ids.size() + vertexIndex];
+    }
+};
+
+// 一批最多 64 * Words 个源点同时 BFS: 每个顶点用 Words 个字表示 "哪些源点已经到达",
+// 一次扫描边就推进整批源点. 方向优化: 前沿的出边少时自顶向下, 只沿前沿顶点的出边推送前沿位;
+// 前沿变大后自底向上, 每个还没被所有源点到达的顶点按入边拉取邻居的前沿位.
+// out 与 in 是同一张图的出边和入边. report(源点在批内的序号, 顶点 index, 距离)
+template <int Words, typename F>
+void multiSourceBfsBatch(const CsrGraph& out,
+                         const CsrGraph& in,
+                         const std::vector<int>& sources,
+                         F&& report) {
+    static_assert(Words >= 1 && Words <= 8, "a batch holds 64 to 512 sources");
+    // 前沿出边数乘以它仍小于总边数时自顶向下
+    constexpr int64_t PushFactor = 14;
+    const int n = in.numVertices();
+    const int64_t m = out.targets.size();
+    std::vector<uint64_t> seen(size_t(n) * Words, 0), visit(size_t(n) * Words, 0),
+        next(size_t(n) * Words, 0);
+    uint64_t full[Words] = {};
+    std::vector<int> frontier, nextFrontier;
+    for(int i = 0; i < sources.size(); i++) {
+        int s = sources[i];
+        if(s < 0)
+            continue;
+        const uint64_t bit = uint64_t(1) << (i % 64);
+        full[i / 64] |= bit;
+        // 同一个顶点可能是批内多个源点
+        if(std::all_of(&visit[size_t(s) * Words], &visit[size_t(s + 1) * Words], [](uint64_t x) { return x == 0; }))
+            frontier.push_back(s);
+        seen[size_t(s) * Words + i / 64] |= bit;
+        visit[size_t(s) * Words + i / 64] |= bit;
+        report(i, s, 0);
+    }
+    // 把 next 中 u 的新到达位记入 seen 并报告, 返回是否有新位; next 中只留下新位
+    auto settle = [&](int u, int level) {
+        uint64_t* nu = &next[size_t(u) * Words];
+        uint64_t* su = &seen[size_t(u) * Words];
+        bool any = false;
+        for(int w = 0; w < Words; w++) {
+            uint64_t fresh = nu[w] & ~su[w];
+            nu[w] = fresh;
+            su[w] |= fresh;
+            any |= fresh != 0;
+            while(fresh) {
+                report(w * 64 + std::countr_zero(fresh), u, level);
+                fresh &= fresh - 1;
+            }
+        }
+        return any;
+    };
+    for(int level = 1; !frontier.empty(); level++) {
+        int64_t frontierEdges = 0;
+        for(int v: frontier)
+            frontierEdges += out.degree(v);
+        nextFrontier.clear();
+        if(frontierEdges * PushFactor < m) {
+            // 自顶向下: 第一次被推到的顶点记入 nextFrontier, 之后再筛掉没有新位的
+            for(int v: frontier) {
+                const uint64_t* vv = &visit[size_t(v) * Words];
+                for(int u: out.neighbors(v)) {
+                    uint64_t* nu = &next[size_t(u) * Words];
+                    bool untouched = true;
+                    for(int w = 0; w < Words; w++) {
+                        untouched &= nu[w] == 0;
+                        nu[w] |= vv[w];
+                    }
+                    if(untouched)
+                        nextFrontier.push_back(u);
+                }
+            }
+            std::erase_if(nextFrontier, [&](int u) {
+                if(settle(u, level))
+                    return false;
+                std::fill_n(&next[size_t(u) * Words], Words, 0);
+                return true;
+            });
+        } else {
+            for(int u = 0; u < n; u++) {
+                uint64_t* su = &seen[size_t(u) * Words];
+                bool done = true;
+                for(int w = 0; w < Words; w++)
+                    done &= su[w] == full[w];
+                if(done)
+                    continue;
+                uint64_t* nu = &next[size_t(u) * Words];
+                for(int v: in.neighbors(u)) {
+                    const uint64_t* vv = &visit[size_t(v) * Words];
+                    for(int w = 0; w < Words; w++)
+                        nu[w] |= vv[w];
+                }
+                if(settle(u, level))
+                    nextFrontier.push_back(u);
+                else
+                    std::fill_n(nu, Words, 0);
+            }
+        }
+        // 旧前沿清零后 visit 全为 0, 与 next 交换, 只有新前沿的位置非零
+        for(int v: frontier)
+            std::fill_n(&visit[size_t(v) * Words], Words, 0);
+        visit.swap(next);
+        frontier.swap(nextFrontier);
+    }
+}
+
+// 把 sources 按 64 * Words 个一批切开, 按 policy 并行处理各批,
+// 对每批调用 run(批首在 sources 中的下标, 批内源点的 index)
+template <int Words, execution::isExecutionPolicy P, typename F>
+void forSourceBatches(const P& policy,
+                      const CsrGraph& graph,
+                      const std::vector<int>& sources,
+                      F&& run) {
+    const int batchSize = 64 * Words;
+    const int numBatches = (int(sources.size()) + batchSize - 1) / batchSize;
+    parallel::parallelFor(
+        policy,
+        0,
+        numBatches,
+        [&](int lo, int hi) {
+            std::vector<int> batch;
+            for(int b = lo; b < hi; b++) {
+                const int first = b * batchSize;
+                const int last = std::min<int>(sources.size(), first + batchSize);
+                batch.clear();
+                for(int i = first; i < last; i++)
+                    batch.push_back(graph.indexOf(sources[i]));
+                run(first, batch);
+            }
+        },
+        1);
+}
+
+// 对 sources 中的每个源点做 BFS, 每到达一个顶点调用 report(源点 id, 顶点 id, 距离).
+// 并行策略下 report 会被并发调用
+template <int Words = 4, execution::isExecutionPolicy P, isGraphView G, typename F>
+void multiSourceBfs(const P& policy, const G& graph, const std::vector<int>& sources, F&& report) {
+    const CsrGraph out = toCsr(graph);
+    const CsrGraph in = transpose(out);
+    forSourceBatches<Words>(policy, in, sources, [&](int first, const std::vector<int>& batch) {
+        multiSourceBfsBatch<Words>(out, in, batch, [&](int i, int v, int d) {
+            report(sources[first + i], in.ids[v], d);
+        });
+    });
+}
+
+template <int Words = 4, isGraphView G, typename F>
+void multiSourceBfs(const G& graph, const std::vector<int>& sources, F&& report) {
+    multiSourceBfs<Words>(execution::seq, graph, sources, std::forward<F>(report));
+}
+
+template <int Words = 4, execution::isExecutionPolicy P, isGraphView G>
+DistanceMatrix multiSourceDistances(const P& policy, const G& graph, const std::vector<int>& sources) {
+    const CsrGraph out = toCsr(graph);
+    const CsrGraph in = transpose(out);
+    const int n = in.numVertices();
+    DistanceMatrix matrix;
+    matrix.ids = in.ids;
+    matrix.sources = sources;
+    matrix.dist.assign(size_t(n) * sources.size(), -1);
+    // 每批只写自己的行, 不需要同步
+    forSourceBatches<Words>(policy, in, sources, [&](int first, const std::vector<int>& batch) {
+        multiSourceBfsBatch<Words>(out, in, batch, [&](int i, int v, int d) {
+            matrix.dist[size_t(first + i) * n + v] = d;
+        });
+    });
+    return matrix;
+}
+
+template <int Words = 4, isGraphView G>
+DistanceMatrix multiSourceDistances(const G& graph, const std::vector<int>& sources) {
+    return multiSourceDistances<Words>(execution::seq, graph, sources);
+}
+
+}  // namespace GraphLib::algorithm
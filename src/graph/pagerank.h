@@ -0,0 +1,267 @@
+#pragma once
+
+#include "csr.h"
+#include "data.h"
+#include "parallel.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace GraphLib::algorithm {
+
+struct PageRankOptions {
+    double damping = 0.85;
+    double tolerance = 1e-10;  // 相邻两轮 L1 变化量小于它时停止
+    int maxIterations = 100;
+    bool weighted = false;  // 按 Edge::weight 的比例分配出链
+};
+
+struct PageRankResult {
+    std::vector<int> ids;  // 按 id 排序, 与 ranks 一一对应
+    std::vector<double> ranks;
+    int iterations = 0;
+    double residual = 0;
+};
+
+namespace detail {
+
+// 把顶点切成 chunks 段, 每段的入边数加顶点数大致相同, 幂律图上枢纽顶点不会让某一段独揽工作
+inline std::vector<int> edgeBalancedBounds(const CsrGraph& in, int chunks) {
+    const int n = in.numVertices();
+    const int64_t total = int64_t(in.offsets[n]) + n;
+    std::vector<int> bounds{0};
+    for(int c = 1; c < chunks; c++) {
+        const int64_t target = total * c / chunks;
+        int lo = bounds.back(), hi = n;
+        while(lo < hi) {
+            const int mid = lo + (hi - lo) / 2;
+            if(int64_t(in.offsets[mid]) + mid < target)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        bounds.push_back(lo);
+    }
+    bounds.push_back(n);
+    return bounds;
+}
+
+// Width 个向量交错存放 (x[v * Width + j]) 的拉取式迭代, 宽度是编译期常量,
+// 每个顶点的累加器是定长数组, 内层循环可以向量化. 只返回前 columns 列的结果
+template <int Width, execution::isExecutionPolicy P>
+std::vector<PageRankResult> pageRankColumns(const P& policy,
+                                            const CsrGraph& in,
+                                            const std::vector<double>& invOutWeight,
+                                            const std::vector<int>& bounds,
+                                            const std::vector<double>& teleport,
+                                            int columns,
+                                            const PageRankOptions& options) {
+    using Column = std::array<double, Width>;
+    const int n = in.numVertices();
+    const int chunks = bounds.size() - 1;
+    const bool weighted = options.weighted;
+    std::vector<double> rank(teleport), next(size_t(n) * Width), contrib(size_t(n) * Width);
+    std::vector<Column> partial(chunks);
+    // 各段的部分和按段的顺序合并, 同样的段数下结果与调度无关
+    auto total = [&] {
+        Column sum{};
+        for(const Column& part: partial) {
+            for(int j = 0; j < Width; j++)
+                sum[j] += part[j];
+        }
+        return sum;
+    };
+    int iterations = 0;
+    double residual = 0;
+    while(iterations < options.maxIterations) {
+        // 出度为 0 的顶点把自己的分数按 teleport 重新分配
+        parallel::parallelFor(
+            policy, 0, chunks,
+            [&](int first, int last) {
+                for(int c = first; c < last; c++) {
+                    Column sum{};
+                    for(int v = bounds[c]; v < bounds[c + 1]; v++) {
+                        const double* r = &rank[size_t(v) * Width];
+                        double* out = &contrib[size_t(v) * Width];
+                        const double inv = invOutWeight[v];
+                        const double dangling = inv == 0;
+                        for(int j = 0; j < Width; j++) {
+                            out[j] = r[j] * inv;
+                            sum[j] += r[j] * dangling;
+                        }
+                    }
+                    partial[c] = sum;
+                }
+            },
+            1);
+        const Column dangling = total();
+        Column base;
+        for(int j = 0; j < Width; j++)
+            base[j] = 1 - options.damping + options.damping * dangling[j];
+
+        parallel::parallelFor(
+            policy, 0, chunks,
+            [&](int first, int last) {
+                for(int c = first; c < last; c++) {
+                    Column delta{};
+                    for(int v = bounds[c]; v < bounds[c + 1]; v++) {
+                        Column acc{};
+                        for(int e = in.offsets[v]; e < in.offsets[v + 1]; e++) {
+                            const double* x = &contrib[size_t(in.targets[e]) * Width];
+                            const double w = weighted ? in.weights[e] : 1;
+                            for(int j = 0; j < Width; j++)
+                                acc[j] += x[j] * w;
+                        }
+                        const double* t = &teleport[size_t(v) * Width];
+                        const double* r = &rank[size_t(v) * Width];
+                        double* x = &next[size_t(v) * Width];
+                        for(int j = 0; j < Width; j++) {
+                            x[j] = base[j] * t[j] + options.damping * acc[j];
+                            delta[j] += std::abs(x[j] - r[j]);
+                        }
+                    }
+                    partial[c] = delta;
+                }
+            },
+            1);
+        const Column diff = total();
+
+        rank.swap(next);
+        iterations++;
+        residual = *std::max_element(diff.begin(), diff.begin() + columns);
+        if(residual < options.tolerance)
+            break;
+    }
+
+    std::vector<PageRankResult> results(columns);
+    for(int j = 0; j < columns; j++) {
+        results[j].ranks.resize(n);
+        for(int v = 0; v < n; v++)
+            results[j].ranks[v] = rank[size_t(v) * Width + j];
+        results[j].iterations = iterations;
+        results[j].residual = residual;
+    }
+    return results;
+}
+
+}  // namespace detail
+
+// 拉取式迭代: 每个顶点沿入边累加邻居的贡献. teleport 中 k 个向量交错存放 (t[v * k + j]),
+// 每一列和为 1. 向量每 8 个一组共享一遍入边扫描, 组宽取不小于组大小的 1, 2, 4 或 8,
+// 多出的列 teleport 为 0, 始终为 0. 普通 PageRank 即宽度为 1 的标量循环
+template <execution::isExecutionPolicy P>
+std::vector<PageRankResult> pageRankKernel(const P& policy,
+                                           const CsrGraph& out,
+                                           const std::vector<double>& teleport,
+                                           int k,
+                                           const PageRankOptions& options) {
+    constexpr int MaxWidth = 8;
+    const int n = out.numVertices();
+    const CsrGraph in = transpose(out);
+    std::vector<double> invOutWeight(n, 0);
+    for(int v = 0; v < n; v++) {
+        double w = out.degree(v);
+        if(options.weighted) {
+            w = 0;
+            for(int weight: out.weightsOf(v))
+                w += weight;
+        }
+        invOutWeight[v] = w > 0 ? 1 / w : 0;
+    }
+    // 段数多于线程数, 段的大小不均时空闲线程可以窃取剩下的段
+    const int chunks = execution::isSequenced<P> ? 1 : 8 * parallel::concurrency(policy);
+    const std::vector<int> bounds = detail::edgeBalancedBounds(in, std::max(1, std::min(chunks, n)));
+
+    std::vector<PageRankResult> results;
+    results.reserve(k);
+    for(int first = 0; first < k; first += MaxWidth) {
+        const int columns = std::min(MaxWidth, k - first);
+        const int width = std::bit_ceil(unsigned(columns));
+        std::vector<double> group(size_t(n) * width, 0);
+        for(int v = 0; v < n; v++) {
+            for(int j = 0; j < columns; j++)
+                group[size_t(v) * width + j] = teleport[size_t(v) * k + first + j];
+        }
+        auto run = [&]<int Width>() {
+            return detail::pageRankColumns<Width>(policy, in, invOutWeight, bounds, group, columns, options);
+        };
+        auto part = width == 1   ? run.template operator()<1>()
+                    : width == 2 ? run.template operator()<2>()
+                    : width == 4 ? run.template operator()<4>()
+                                 : run.template operator()<8>();
+        for(auto& result: part) {
+            result.ids = out.ids;
+            results.push_back(std::move(result));
+        }
+    }
+    return results;
+}
+
+template <execution::isExecutionPolicy P, isGraphView G>
+PageRankResult pageRank(const P& policy, const G& graph, const PageRankOptions& options = {}) {
+    const auto csr = toCsr(graph);
+    const int n = csr.numVertices();
+    if(n == 0)
+        return {};
+    std::vector<double> teleport(n, 1.0 / n);
+    return pageRankKernel(policy, csr, teleport, 1, options)[0];
+}
+
+template <isGraphView G>
+PageRankResult pageRank(const G& graph, const PageRankOptions& options = {}) {
+    return pageRank(execution::seq, graph, options);
+}
+
+// 每组种子各得到一个向量, 每 8 组共享同一遍入边扫描
+template <execution::isExecutionPolicy P, isGraphView G>
+std::vector<PageRankResult> personalizedPageRankBatch(const P& policy,
+                                                      const G& graph,
+                                                      const std::vector<std::vector<int>>& seedSets,
+                                                      const PageRankOptions& options = {}) {
+    const auto csr = toCsr(graph);
+    const int k = seedSets.size();
+    if(k == 0)
+        return {};
+    std::vector<double> teleport(size_t(csr.numVertices()) * k, 0);
+    for(int j = 0; j < k; j++) {
+        std::vector<int> indices;
+        for(int id: seedSets[j]) {
+            if(int index = csr.indexOf(id); index >= 0)
+                indices.push_back(index);
+        }
+        if(indices.empty()) {
+            throw std::runtime_error("No seed vertex in graph");
+        }
+        for(int index: indices)
+            teleport[size_t(index) * k + j] += 1.0 / indices.size();
+    }
+    return pageRankKernel(policy, csr, teleport, k, options);
+}
+
+template <isGraphView G>
+std::vector<PageRankResult> personalizedPageRankBatch(const G& graph,
+                                                      const std::vector<std::vector<int>>& seedSets,
+                                                      const PageRankOptions& options = {}) {
+    return personalizedPageRankBatch(execution::seq, graph, seedSets, options);
+}
+
+template <execution::isExecutionPolicy P, isGraphView G>
+PageRankResult personalizedPageRank(const P& policy,
+                                    const G& graph,
+                                    const std::vector<int>& seeds,
+                                    const PageRankOptions& options = {}) {
+    return personalizedPageRankBatch(policy, graph, std::vector<std::vector<int>>{seeds}, options)[0];
+}
+
+template <isGraphView G>
+PageRankResult personalizedPageRank(const G& graph,
+                                    const std::vector<int>& seeds,
+                                    const PageRankOptions& options = {}) {
+    return personalizedPageRank(execution::seq, graph, seeds, options);
+}
+
+}  // namespace GraphLib::algorithm
@@ -0,0 +1,354 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace GraphLib::parallel {
+
+inline unsigned defaultThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// 一次 fork-join 中派生出的任务计数, 以及第一个抛出的异常
+class TaskGroup {
+public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup&) = delete;
+
+    [[nodiscard]] bool done() const {
+        return pending.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class ThreadPool;
+
+    std::atomic<int> pending{0};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    void fail(std::exception_ptr e) {
+        std::lock_guard lock(errorMutex);
+        if(!error)
+            error = std::move(e);
+    }
+};
+
+// 工作窃取线程池: 每个工作线程一个双端队列, 自己从尾部压入和取出 (后进先出, 保持局部性),
+// 空闲时从其它队列的头部窃取 (先进先出, 偷到的是较大的任务). 池外线程提交的任务进入共享队列.
+// 等待一组任务的线程不会阻塞, 而是帮忙执行任务, 因此任务内部可以再嵌套并行.
+// cpus 非空时第 i 个工作线程绑定到 cpus[i % cpus.size()] (仅 Linux), 传入同一 NUMA 节点的
+// CPU 可以让池的线程和它们分配的内存留在同一节点
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = defaultThreads(), std::vector<int> cpus = {}) :
+        queues(std::max(1u, threads)) {
+        workers.reserve(queues.size());
+        for(int i = 0; i < queues.size(); i++) {
+            workers.emplace_back([this, i] { workerLoop(i); });
+#ifdef __linux__
+            if(!cpus.empty()) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpus[i % cpus.size()], &set);
+                pthread_setaffinity_np(workers.back().native_handle(), sizeof(set), &set);
+            }
+#endif
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(sleepMutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for(auto& worker: workers) {
+            worker.join();
+        }
+    }
+
+    [[nodiscard]] unsigned size() const {
+        return workers.size();
+    }
+
+    // 当前线程是否是本池的工作线程
+    [[nodiscard]] bool isWorker() const {
+        return currentPool == this;
+    }
+
+    // 当前线程自己的队列是否为空, 池外线程总是返回 true. 用于按需切分任务
+    [[nodiscard]] bool localQueueEmpty() {
+        if(!isWorker())
+            return true;
+        Queue& queue = queues[currentWorker];
+        std::lock_guard lock(queue.mutex);
+        return queue.tasks.empty();
+    }
+
+    template <typename F>
+    void spawn(TaskGroup& group, F&& f) {
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+        Task task = [this, &group, f = std::forward<F>(f)]() mutable {
+            try {
+                f();
+            } catch(...) {
+                group.fail(std::current_exception());
+            }
+            // 计数归零后等待方随时可能销毁 group, 之后只能访问池自己的成员
+            if(group.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                {
+                    std::lock_guard lock(doneMutex);
+                }
+                groupDone.notify_all();
+            }
+        };
+        Queue& queue = isWorker() ? queues[currentWorker] : injected;
+        {
+            std::lock_guard lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        queued.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard lock(sleepMutex);
+        }
+        wakeUp.notify_one();
+    }
+
+    // 等待 group 的任务全部完成, 期间帮忙执行任务; 有任务抛出异常时在这里重新抛出.
+    // 没有可帮的任务时, 工作线程先让出几次 CPU (剩下的任务往往马上结束), 之后和池外线程一样阻塞.
+    // 所有队列此刻都是空的, 剩下的任务正在别的线程上运行, 它们派生的子任务由派生者自己等待时执行,
+    // 所以阻塞不会让任何任务无人执行
+    void wait(TaskGroup& group) {
+        constexpr int MaxSpins = 64;
+        int spins = 0;
+        while(!group.done()) {
+            if(runOne()) {
+                spins = 0;
+                continue;
+            }
+            if(isWorker() && spins++ < MaxSpins) {
+                std::this_thread::yield();
+            } else {
+                std::unique_lock lock(doneMutex);
+                groupDone.wait(lock, [&] { return group.done(); });
+            }
+        }
+        if(group.error)
+            std::rethrow_exception(group.error);
+    }
+
+private:
+    using Task = std::function<void()>;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<Queue> queues;
+    Queue injected;
+    std::vector<std::thread> workers;
+    std::atomic<int> queued{0};
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+    std::mutex doneMutex;
+    std::condition_variable groupDone;
+
+    static inline thread_local ThreadPool* currentPool = nullptr;
+    static inline thread_local int currentWorker = -1;
+
+    // 先取自己队列的尾部, 再依次窃取共享队列和其它队列的头部
+    bool runOne() {
+        Task task;
+        if(isWorker()) {
+            Queue& own = queues[currentWorker];
+            std::lock_guard lock(own.mutex);
+            if(!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+            }
+        }
+        const int start = isWorker() ? currentWorker + 1 : 0;
+        for(int i = -1; !task && i < int(queues.size()); i++) {
+            Queue& victim = i < 0 ? injected : queues[(start + i) % queues.size()];
+            std::lock_guard lock(victim.mutex);
+            if(!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+            }
+        }
+        if(!task)
+            return false;
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        return true;
+    }
+
+    void workerLoop(int index) {
+        currentPool = this;
+        currentWorker = index;
+        while(true) {
+            if(runOne())
+                continue;
+            std::unique_lock lock(sleepMutex);
+            wakeUp.wait(lock, [&] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+            if(stopping)
+                return;
+        }
+    }
+};
+
+// 进程内共享的池, 第一次使用时按硬件线程数创建
+inline ThreadPool& defaultPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+}  // namespace GraphLib::parallel
+
+// 执行策略, 在编译期选择算法的实现: seq 单线程, par 使用 defaultPool(), on(pool) 使用指定的池
+namespace GraphLib::execution {
+
+struct SequencedPolicy {};
+
+struct ParallelPolicy {};
+
+struct PoolPolicy {
+    parallel::ThreadPool* pool;
+};
+
+inline constexpr SequencedPolicy seq{};
+inline constexpr ParallelPolicy par{};
+
+inline PoolPolicy on(parallel::ThreadPool& pool) {
+    return {&pool};
+}
+
+template <typename P>
+concept isExecutionPolicy = std::same_as<std::remove_cvref_t<P>, SequencedPolicy>
+                            || std::same_as<std::remove_cvref_t<P>, ParallelPolicy>
+                            || std::same_as<std::remove_cvref_t<P>, PoolPolicy>;
+
+template <isExecutionPolicy P>
+inline constexpr bool isSequenced = std::same_as<std::remove_cvref_t<P>, SequencedPolicy>;
+
+}  // namespace GraphLib::execution
+
+namespace GraphLib::parallel {
+
+template <execution::isExecutionPolicy P>
+ThreadPool& poolOf(const P& policy) {
+    if constexpr(std::same_as<P, execution::PoolPolicy>)
+        return *policy.pool;
+    else
+        return defaultPool();
+}
+
+// 策略下最多同时运行的块数, 用来确定每块各自的缓冲区个数
+template <execution::isExecutionPolicy P>
+unsigned concurrency(const P& policy) {
+    if constexpr(execution::isSequenced<P>)
+        return 1;
+    else
+        return poolOf(policy).size();
+}
+
+// 把 [begin, end) 切成不超过 concurrency(policy) 个连续块, 第 b 块调用 f(b, lo, hi).
+// 第 0 块在调用线程上执行. 块数固定, 适合需要按块存放部分结果的场合
+template <execution::isExecutionPolicy P, typename F>
+void forBlocks(const P& policy, int begin, int end, F&& f) {
+    const int n = end - begin;
+    if(n <= 0)
+        return;
+    const int blocks = std::clamp<int>(concurrency(policy), 1, n);
+    auto bound = [&](int b) { return begin + int(int64_t(n) * b / blocks); };
+    if(blocks == 1) {
+        f(0, begin, end);
+        return;
+    }
+    ThreadPool& pool = poolOf(policy);
+    TaskGroup group;
+    for(int b = 1; b < blocks; b++) {
+        pool.spawn(group, [&f, b, lo = bound(b), hi = bound(b + 1)] { f(b, lo, hi); });
+    }
+    std::exception_ptr error;
+    try {
+        f(0, bound(0), bound(1));
+    } catch(...) {
+        error = std::current_exception();
+    }
+    // 派生的任务引用了 f, 无论如何都要等它们结束
+    pool.wait(group);
+    if(error)
+        std::rethrow_exception(error);
+}
+
+// f(lo, hi) 处理一段连续区间. 惰性二分: 每次先看自己的队列, 空了 (说明别人可能没活干)
+// 才把剩余区间对半分出去一半, 否则按 grain 一段段做完. grain 为 0 时取 n / (8 * 线程数)
+template <execution::isExecutionPolicy P, typename F>
+void parallelFor(const P& policy, int begin, int end, F&& f, int grain = 0) {
+    if(end <= begin)
+        return;
+    if constexpr(execution::isSequenced<P>) {
+        f(begin, end);
+    } else {
+        ThreadPool& pool = poolOf(policy);
+        if(grain <= 0)
+            grain = std::max<int>(1, (end - begin) / (8 * (pool.size() + 1)));
+        TaskGroup group;
+        std::function<void(int, int)> run = [&](int lo, int hi) {
+            while(hi - lo > grain) {
+                if(pool.localQueueEmpty()) {
+                    const int mid = lo + (hi - lo) / 2;
+                    pool.spawn(group, [&run, mid, hi] { run(mid, hi); });
+                    hi = mid;
+                } else {
+                    f(lo, lo + grain);
+                    lo += grain;
+                }
+            }
+            f(lo, hi);
+        };
+        std::exception_ptr error;
+        try {
+            run(begin, end);
+        } catch(...) {
+            error = std::current_exception();
+        }
+        pool.wait(group);
+        if(error)
+            std::rethrow_exception(error);
+    }
+}
+
+// f(lo, hi) 返回一段区间的部分结果, 按块的顺序用 combine 合并, 块数只取决于策略, 结果可复现
+template <execution::isExecutionPolicy P, typename T, typename F, typename Combine>
+T parallelReduce(const P& policy, int begin, int end, T init, F&& f, Combine&& combine) {
+    if(end <= begin)
+        return init;
+    std::vector<T> partial(std::clamp<int>(concurrency(policy), 1, end - begin), init);
+    forBlocks(policy, begin, end, [&](int b, int lo, int hi) { partial[b] = f(lo, hi); });
+    for(const auto& value: partial) {
+        init = combine(init, value);
+    }
+    return init;
+}
+
+}  // namespace GraphLib::parallel
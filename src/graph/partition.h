@@ -0,0 +1,388 @@
+#pragma once
+
+#include "csr.h"
+#include "data.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <exception>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace GraphLib {
+
+struct Partitioning {
+    std::vector<int> ids;    // 与 CsrGraph 相同的顶点顺序
+    std::vector<int> owner;  // 每个顶点所属的分片
+    int numShards = 0;
+};
+
+// 一个分片: 自己拥有的顶点在前, ghost 顶点 (其他分片拥有的邻居) 在后,
+// 只为自己的顶点保存出边
+struct Shard {
+    int shardId = 0;
+    int numShards = 0;
+    int numLocal = 0;
+    std::vector<int> globalIds;   // local index -> vertex id
+    std::vector<int> ghostOwner;  // (local index - numLocal) -> 拥有该顶点的分片
+    std::vector<int> offsets;     // size numLocal + 1
+    std::vector<int> targets;     // local index, 可能是 ghost
+    std::vector<int> weights;
+    std::unordered_map<int, int> globalToLocal;
+
+    [[nodiscard]] bool isGhost(int local) const {
+        return local >= numLocal;
+    }
+
+    [[nodiscard]] int numGhosts() const {
+        return globalIds.size() - numLocal;
+    }
+
+    [[nodiscard]] int ownerOf(int local) const {
+        return isGhost(local) ? ghostOwner[local - numLocal] : shardId;
+    }
+
+    [[nodiscard]] std::span<const int> neighbors(int local) const {
+        return {targets.data() + offsets[local], targets.data() + offsets[local + 1]};
+    }
+};
+
+// 分片之间传递的消息, target 是接收方拥有的顶点 id
+struct ShardMessage {
+    int target;
+    int value;
+};
+
+// BSP 消息传输: send 发出的消息在双方都经过 sync 之后才能被 receive 取到.
+// sync 同时是全局屏障和对 active 的全局或
+template <typename T>
+concept isShardTransport = requires(T t, int shard, bool active, std::vector<ShardMessage> msgs) {
+    t.send(shard, shard, std::move(msgs));
+    { t.sync(shard, active) } -> std::same_as<bool>;
+    { t.receive(shard) } -> std::same_as<std::vector<ShardMessage>>;
+};
+
+// 单进程内的传输, 每个分片一个线程, 用于测试和单机运行.
+// 分片之间最多相差一个超步, 所以信箱按超步奇偶双缓冲.
+// 某个分片出错时调用 abort, 正在或之后在 sync 等待的分片都会抛异常退出, 而不是永远等下去
+class InProcessTransport {
+public:
+    explicit InProcessTransport(int numShards) :
+        numShards(numShards), mailboxes(numShards * 2), mailboxMutexes(numShards),
+        steps(numShards, 0) {}
+
+    void send(int from, int to, std::vector<ShardMessage> messages) {
+        std::lock_guard lock(mailboxMutexes[to]);
+        auto& box = mailboxes[to * 2 + steps[from] % 2];
+        if(box.empty())
+            box = std::move(messages);
+        else
+            box.insert(box.end(), messages.begin(), messages.end());
+    }
+
+    bool sync(int shard, bool active) {
+        std::unique_lock lock(syncMutex);
+        if(failure)
+            throw std::runtime_error("Shard transport aborted");
+        pendingActive = pendingActive || active;
+        if(++arrived == numShards) {
+            lastActive = pendingActive;
+            pendingActive = false;
+            arrived = 0;
+            generation++;
+            syncCv.notify_all();
+        } else {
+            auto current = generation;
+            syncCv.wait(lock, [&] { return generation != current || failure; });
+            if(generation == current)
+                throw std::runtime_error("Shard transport aborted");
+        }
+        steps[shard]++;
+        return lastActive;
+    }
+
+    // 只记录第一个错误, 之后因为中止而抛出的异常不会覆盖它
+    void abort(std::exception_ptr error) {
+        {
+            std::lock_guard lock(syncMutex);
+            if(!failure)
+                failure = std::move(error);
+        }
+        syncCv.notify_all();
+    }
+
+    [[nodiscard]] std::exception_ptr error() const {
+        std::lock_guard lock(syncMutex);
+        return failure;
+    }
+
+    std::vector<ShardMessage> receive(int shard) {
+        std::lock_guard lock(mailboxMutexes[shard]);
+        return std::exchange(mailboxes[shard * 2 + (steps[shard] - 1) % 2], {});
+    }
+
+private:
+    int numShards;
+    std::vector<std::vector<ShardMessage>> mailboxes;
+    std::vector<std::mutex> mailboxMutexes;
+    std::vector<long long> steps;
+    mutable std::mutex syncMutex;
+    std::condition_variable syncCv;
+    std::exception_ptr failure;
+    int arrived = 0;
+    long long generation = 0;
+    bool pendingActive = false;
+    bool lastActive = false;
+};
+
+// 被切断的边数 (无向图的边在两个方向上各算一次)
+inline int cutArcs(const CsrGraph& csr, const Partitioning& partitioning) {
+    int cut = 0;
+    for(int v = 0; v < csr.numVertices(); v++) {
+        for(int u: csr.neighbors(v)) {
+            cut += partitioning.owner[u] != partitioning.owner[v];
+        }
+    }
+    return cut;
+}
+
+// Linear Deterministic Greedy 流式划分: 顶点按 CSR 顺序到达, 放进
+// |已在分片内的邻居| * (1 - 分片大小 / 容量) 最大的分片, 容量为 (1 + imbalance) * n / k
+inline Partitioning partitionLdg(const CsrGraph& csr, int numShards, double imbalance = 0.05) {
+    const int n = csr.numVertices();
+    numShards = std::max(1, numShards);
+    const CsrGraph adj = simpleUndirected(csr);
+    const double capacity = std::max(1.0, std::ceil((1 + imbalance) * n / numShards));
+
+    Partitioning partitioning;
+    partitioning.ids = csr.ids;
+    partitioning.owner.assign(n, -1);
+    partitioning.numShards = numShards;
+    std::vector<int> sizes(numShards, 0), together(numShards, 0);
+    for(int v = 0; v < n; v++) {
+        for(int u: adj.neighbors(v)) {
+            if(partitioning.owner[u] >= 0)
+                together[partitioning.owner[u]]++;
+        }
+        int best = -1;
+        double bestScore = -1;
+        for(int s = 0; s < numShards; s++) {
+            if(sizes[s] >= capacity)
+                continue;
+            double score = together[s] * (1 - sizes[s] / capacity);
+            if(best < 0 || score > bestScore || (score == bestScore && sizes[s] < sizes[best])) {
+                best = s;
+                bestScore = score;
+            }
+        }
+        partitioning.owner[v] = best;
+        sizes[best]++;
+        for(int u: adj.neighbors(v)) {
+            if(partitioning.owner[u] >= 0)
+                together[partitioning.owner[u]] = 0;
+        }
+    }
+    return partitioning;
+}
+
+inline std::vector<Shard> buildShards(const CsrGraph& csr, const Partitioning& partitioning) {
+    std::vector<Shard> shards(partitioning.numShards);
+    for(int s = 0; s < shards.size(); s++) {
+        shards[s].shardId = s;
+        shards[s].numShards = partitioning.numShards;
+    }
+    for(int v = 0; v < csr.numVertices(); v++) {
+        auto& shard = shards[partitioning.owner[v]];
+        shard.globalToLocal.emplace(csr.ids[v], shard.globalIds.size());
+        shard.globalIds.push_back(csr.ids[v]);
+    }
+    for(auto& shard: shards) {
+        shard.numLocal = shard.globalIds.size();
+        shard.offsets.assign(shard.numLocal + 1, 0);
+    }
+    for(auto& shard: shards) {
+        for(int local = 0; local < shard.numLocal; local++) {
+            int v = csr.indexOf(shard.globalIds[local]);
+            auto ws = csr.weightsOf(v);
+            auto ns = csr.neighbors(v);
+            for(int i = 0; i < ns.size(); i++) {
+                int id = csr.ids[ns[i]];
+                auto [it, inserted] = shard.globalToLocal.emplace(id, shard.globalIds.size());
+                if(inserted) {
+                    shard.globalIds.push_back(id);
+                    shard.ghostOwner.push_back(partitioning.owner[ns[i]]);
+                }
+                shard.targets.push_back(it->second);
+                shard.weights.push_back(ws[i]);
+            }
+            shard.offsets[local + 1] = shard.targets.size();
+        }
+    }
+    return shards;
+}
+
+// 有向图的分片只保存出边; 需要弱连通分量时先用 simpleUndirected 再调用 buildShards
+template <isGraphView G>
+std::vector<Shard> shardGraph(const G& graph, int numShards, double imbalance = 0.05) {
+    const CsrGraph csr = toCsr(graph);
+    return buildShards(csr, partitionLdg(csr, numShards, imbalance));
+}
+
+}  // namespace GraphLib
+
+namespace GraphLib::algorithm {
+
+// 在一个分片上执行 BSP 广度优先搜索, 每个分片调用一次, 返回自己拥有的顶点的距离
+// (下标为 local index, 不可达为 -1)
+template <isShardTransport Transport>
+std::vector<int> shardBfs(const Shard& shard, Transport& transport, int source) {
+    std::vector<int> dist(shard.numLocal, -1);
+    std::vector<char> ghostSent(shard.numGhosts(), false);
+    std::vector<int> frontier, next;
+    if(auto it = shard.globalToLocal.find(source);
+       it != shard.globalToLocal.end() && !shard.isGhost(it->second)) {
+        dist[it->second] = 0;
+        frontier.push_back(it->second);
+    }
+    std::vector<std::vector<ShardMessage>> outgoing(shard.numShards);
+    for(int level = 0;; level++) {
+        bool sent = false;
+        for(int v: frontier) {
+            for(int t: shard.neighbors(v)) {
+                if(shard.isGhost(t)) {
+                    // 最早到达的消息距离最小, 每个 ghost 只需要发一次
+                    if(!ghostSent[t - shard.numLocal]) {
+                        ghostSent[t - shard.numLocal] = true;
+                        outgoing[shard.ownerOf(t)].push_back({shard.globalIds[t], level + 1});
+                    }
+                } else if(dist[t] < 0) {
+                    dist[t] = level + 1;
+                    next.push_back(t);
+                }
+            }
+        }
+        for(int s = 0; s < shard.numShards; s++) {
+            if(!outgoing[s].empty()) {
+                transport.send(shard.shardId, s, std::move(outgoing[s]));
+                outgoing[s].clear();
+                sent = true;
+            }
+        }
+        bool active = transport.sync(shard.shardId, sent || !next.empty());
+        for(const auto& msg: transport.receive(shard.shardId)) {
+            int local = shard.globalToLocal.at(msg.target);
+            if(dist[local] < 0) {
+                dist[local] = msg.value;
+                next.push_back(local);
+            }
+        }
+        if(!active)
+            break;
+        frontier.swap(next);
+        next.clear();
+    }
+    return dist;
+}
+
+// 在一个分片上执行 BSP 连通分量 (最小 id 标签传播), 返回自己拥有的顶点的分量标签.
+// 分片内先传播到稳定, 再把变小的 ghost 标签发给拥有者
+template <isShardTransport Transport>
+std::vector<int> shardConnectedComponents(const Shard& shard, Transport& transport) {
+    std::vector<int> label(shard.globalIds.begin(), shard.globalIds.begin() + shard.numLocal);
+    std::vector<int> ghostLabel(shard.globalIds.begin() + shard.numLocal, shard.globalIds.end());
+    std::vector<int> worklist(shard.numLocal);
+    std::iota(worklist.begin(), worklist.end(), 0);
+    std::vector<std::vector<ShardMessage>> outgoing(shard.numShards);
+    while(true) {
+        std::vector<int> dirtyGhosts;
+        while(!worklist.empty()) {
+            int v = worklist.back();
+            worklist.pop_back();
+            for(int t: shard.neighbors(v)) {
+                if(shard.isGhost(t)) {
+                    int g = t - shard.numLocal;
+                    if(label[v] < ghostLabel[g]) {
+                        ghostLabel[g] = label[v];
+                        dirtyGhosts.push_back(g);
+                    }
+                } else if(label[v] < label[t]) {
+                    label[t] = label[v];
+                    worklist.push_back(t);
+                } else if(label[t] < label[v]) {
+                    label[v] = label[t];
+                    worklist.push_back(v);
+                }
+            }
+        }
+        bool sent = false;
+        for(int g: dirtyGhosts) {
+            outgoing[shard.ghostOwner[g]].push_back({shard.globalIds[shard.numLocal + g], ghostLabel[g]});
+        }
+        for(int s = 0; s < shard.numShards; s++) {
+            if(!outgoing[s].empty()) {
+                transport.send(shard.shardId, s, std::move(outgoing[s]));
+                outgoing[s].clear();
+                sent = true;
+            }
+        }
+        bool active = transport.sync(shard.shardId, sent);
+        for(const auto& msg: transport.receive(shard.shardId)) {
+            int local = shard.globalToLocal.at(msg.target);
+            if(msg.value < label[local]) {
+                label[local] = msg.value;
+                worklist.push_back(local);
+            }
+        }
+        if(!active)
+            break;
+    }
+    return label;
+}
+
+// 每个分片一个线程, 通过 InProcessTransport 运行 runner, 按顶点 id 汇总结果.
+// 分片之间在 sync 处互相等待, 不能共用可能被占满的池, 因此单独建一个每分片一个线程的池.
+// 某个分片抛出异常时中止传输, 其它分片随之退出, 最后重新抛出最先发生的异常
+template <typename Runner>
+std::unordered_map<int, int> runShardsInProcess(const std::vector<Shard>& shards, Runner&& runner) {
+    InProcessTransport transport(shards.size());
+    std::vector<std::vector<int>> results(shards.size());
+    parallel::ThreadPool pool(shards.size());
+    parallel::forBlocks(execution::on(pool), 0, shards.size(), [&](int, int lo, int hi) {
+        for(int s = lo; s < hi; s++) {
+            try {
+                results[s] = runner(shards[s], transport);
+            } catch(...) {
+                transport.abort(std::current_exception());
+            }
+        }
+    });
+    if(auto error = transport.error())
+        std::rethrow_exception(error);
+    std::unordered_map<int, int> merged;
+    for(int s = 0; s < shards.size(); s++) {
+        for(int local = 0; local < shards[s].numLocal; local++)
+            merged.emplace(shards[s].globalIds[local], results[s][local]);
+    }
+    return merged;
+}
+
+inline std::unordered_map<int, int> distributedBfs(const std::vector<Shard>& shards, int source) {
+    return runShardsInProcess(shards, [source](const Shard& shard, InProcessTransport& transport) {
+        return shardBfs(shard, transport, source);
+    });
+}
+
+inline std::unordered_map<int, int> distributedConnectedComponents(const std::vector<Shard>& shards) {
+    return runShardsInProcess(shards, [](const Shard& shard, InProcessTransport& transport) {
+        return shardConnectedComponents(shard, transport);
+    });
+}
+
+}  // namespace GraphLib::algorithm
@@ -0,0 +1,485 @@
+#pragma once
+
+#include "csr.h"
+#include "data.h"
+#include "export.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <expected>
+#include <fcntl.h>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace GraphLib {
+
+class DistanceIndex;
+
+template <execution::isExecutionPolicy P, isGraphView G>
+DistanceIndex buildDistanceIndex(const P& policy, const G& graph);
+
+// 剪枝地标标签 (pruned landmark labeling) 距离索引, 回答无权最短距离.
+// 顶点按度数从大到小排名, 排名就是内部编号; 每个顶点的 2-hop 标签是按 hub 排名升序的
+// (hub, 距离) 对, 全部顶点的标签拼接在一块连续数组里.
+// 有向图分入标签 (hub 到该点的距离) 和出标签 (该点到 hub 的距离), 无向图只有一组
+class DistanceIndex {
+public:
+    DistanceIndex() = default;
+
+    [[nodiscard]] int numVertices() const {
+        return ids.size();
+    }
+
+    [[nodiscard]] bool isDirected() const {
+        return directed;
+    }
+
+    [[nodiscard]] size_t numLabelEntries() const {
+        // 不计每个顶点末尾的哨兵
+        return in.hubs.size() + out.hubs.size() - (directed ? 2 : 1) * ids.size();
+    }
+
+    // 不可达返回 -1, 顶点不在索引中时抛异常
+    [[nodiscard]] int distance(int from, int to) const {
+        const int s = rankOf(from), t = rankOf(to);
+        if(s == t)
+            return 0;
+        const Labels& source = directed ? out : in;
+        const int* ha = source.hubs.data() + source.offsets[s];
+        const int* da = source.dists.data() + source.offsets[s];
+        const int* hb = in.hubs.data() + in.offsets[t];
+        const int* db = in.dists.data() + in.offsets[t];
+        // 两个标签都以哨兵结尾, 循环体里只有一次比较是真正的分支
+        int best = Unreachable;
+        while(true) {
+            const int a = *ha, b = *hb;
+            if(a == b) {
+                if(a == Sentinel)
+                    break;
+                best = std::min(best, *da + *db);
+            }
+            const bool stepA = a <= b, stepB = b <= a;
+            ha += stepA;
+            da += stepA;
+            hb += stepB;
+            db += stepB;
+        }
+        return best == Unreachable ? -1 : best;
+    }
+
+    // 插入新边后增量更新标签: 对端点已有标签里的每个 hub, 从新边的另一端继续剪枝 BFS.
+    // 旧标签项不删除, 只会新增或缩短, 因此标签可能比重建略大.
+    // 每次调用要把标签展开再压回连续数组, 新边应尽量成批传入
+    void addEdges(const std::vector<std::pair<int, int>>& edges) {
+        LabelLists inLists = in.toLists(), outLists = directed ? out.toLists() : LabelLists{};
+        Scratch scratch(ids.size());
+        for(auto [fromId, toId]: edges) {
+            const int a = rankOf(fromId), b = rankOf(toId);
+            forward[a].push_back(b);
+            if(directed) {
+                backward[b].push_back(a);
+                resumeFromEdge(a, b, inLists, outLists, forward, scratch);
+                resumeFromEdge(b, a, outLists, inLists, backward, scratch);
+            } else {
+                forward[b].push_back(a);
+                resumeFromEdge(a, b, inLists, inLists, forward, scratch);
+                resumeFromEdge(b, a, inLists, inLists, forward, scratch);
+            }
+        }
+        in = Labels(inLists);
+        if(directed)
+            out = Labels(outLists);
+    }
+
+    // 原生字节序的二进制格式, 失败时返回 errno
+    [[nodiscard]] std::expected<void, int> save(const std::string& path) const {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(fd < 0)
+            return std::unexpected(errno);
+        bool ok;
+        {
+            io::BufferedSink<io::FdWriter> sink(io::FdWriter{fd});
+            sink.write(Magic);
+            writeArray(sink, std::vector<int>{directed});
+            writeArray(sink, ids);
+            for(const Labels* labels: {&in, &out}) {
+                writeArray(sink, labels->offsets);
+                writeArray(sink, labels->hubs);
+                writeArray(sink, labels->dists);
+            }
+            for(const Adjacency* adjacency: {&forward, &backward}) {
+                for(const auto& targets: *adjacency) {
+                    writeArray(sink, targets);
+                }
+            }
+            ok = sink.flush();
+        }
+        int err = ok ? 0 : errno;
+        if(::close(fd) != 0 && ok) {
+            ok = false;
+            err = errno;
+        }
+        if(!ok)
+            return std::unexpected(err);
+        return {};
+    }
+
+    // 文件格式不对时返回 EINVAL
+    [[nodiscard]] static std::expected<DistanceIndex, int> load(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0)
+            return std::unexpected(errno);
+        DistanceIndex index;
+        int err = index.readFrom(fd);
+        ::close(fd);
+        if(err != 0)
+            return std::unexpected(err);
+        return index;
+    }
+
+    template <execution::isExecutionPolicy P, isGraphView G>
+    friend DistanceIndex buildDistanceIndex(const P& policy, const G& graph);
+
+private:
+    static constexpr int Sentinel = INT_MAX;
+    static constexpr int Unreachable = INT_MAX / 2;
+    static constexpr std::string_view Magic = "GraphLibPLL1";
+
+    struct LabelEntry {
+        int hub;
+        int dist;
+    };
+
+    // 构建和增量更新时每个顶点一个可变的标签, 按 hub 升序
+    using LabelLists = std::vector<std::vector<LabelEntry>>;
+    using Adjacency = std::vector<std::vector<int>>;
+
+    // 所有顶点的标签拼接存放, 第 v 个顶点占 [offsets[v], offsets[v + 1]), 末尾是哨兵
+    struct Labels {
+        std::vector<int> offsets;
+        std::vector<int> hubs;
+        std::vector<int> dists;
+
+        Labels() = default;
+
+        explicit Labels(const LabelLists& lists) {
+            offsets.reserve(lists.size() + 1);
+            offsets.push_back(0);
+            for(const auto& label: lists) {
+                for(auto [hub, dist]: label) {
+                    hubs.push_back(hub);
+                    dists.push_back(dist);
+                }
+                hubs.push_back(Sentinel);
+                dists.push_back(0);
+                offsets.push_back(hubs.size());
+            }
+        }
+
+        [[nodiscard]] LabelLists toLists() const {
+            LabelLists lists(offsets.empty() ? 0 : offsets.size() - 1);
+            for(int v = 0; v < lists.size(); v++) {
+                for(int i = offsets[v]; i + 1 < offsets[v + 1]; i++) {
+                    lists[v].push_back({hubs[i], dists[i]});
+                }
+            }
+            return lists;
+        }
+
+        // 读入的标签能否安全使用: 偏移单调, 每个标签按 hub 严格升序, hub 与距离都在 [0, n) 内,
+        // 末尾是距离为 0 的哨兵
+        [[nodiscard]] bool valid(int n) const {
+            if(offsets.size() != n + 1 || offsets[0] != 0 || offsets.back() != hubs.size()
+               || dists.size() != hubs.size())
+                return false;
+            for(int v = 0; v < n; v++) {
+                const int begin = offsets[v], end = offsets[v + 1];
+                if(end <= begin || end > hubs.size() || hubs[end - 1] != Sentinel || dists[end - 1] != 0)
+                    return false;
+                for(int i = begin; i + 1 < end; i++) {
+                    if(hubs[i] < 0 || hubs[i] >= n || (i > begin && hubs[i] <= hubs[i - 1])
+                       || dists[i] < 0 || dists[i] >= n)
+                        return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    // 每个 BFS 线程自己的工作区, 用完只复位碰过的位置
+    struct Scratch {
+        std::vector<int> hubDist;  // 当前 hub 自己那一侧标签的稠密展开
+        std::vector<int> dist;
+        std::vector<int> queue;
+
+        explicit Scratch(int n) : hubDist(n, Unreachable), dist(n, -1) {
+            queue.reserve(n);
+        }
+    };
+
+    bool directed = false;
+    std::vector<int> ids;  // 排名 -> 顶点 id
+    std::unordered_map<int, int> idToRank;
+    Labels in;   // 无向图时是唯一的一组标签
+    Labels out;  // 只有有向图使用
+    Adjacency forward;
+    Adjacency backward;  // 只有有向图使用
+
+    [[nodiscard]] int rankOf(int id) const {
+        auto it = idToRank.find(id);
+        if(it == idToRank.end())
+            throw std::runtime_error("Vertex not in distance index");
+        return it->second;
+    }
+
+    // hub 一侧已有的标签能否以不超过 d 的距离覆盖 u
+    static bool covered(const Scratch& scratch, const std::vector<LabelEntry>& label, int d) {
+        for(auto [hub, dist]: label) {
+            if(scratch.hubDist[hub] + dist <= d)
+                return true;
+        }
+        return false;
+    }
+
+    // 从 hub 出发的剪枝 BFS, 以距离 startDist 从 start 开始, 沿 adjacency 前进.
+    // hubSide 是 hub 自己用于剪枝的标签, farSide 是被到达顶点的标签.
+    // 排名比 hub 靠前的顶点由它们自己的 BFS 覆盖, 直接跳过.
+    // visit(u, d) 记录新的标签项
+    template <typename Visit>
+    static void prunedBfs(int hub,
+                          int start,
+                          int startDist,
+                          const Adjacency& adjacency,
+                          const LabelLists& hubSide,
+                          const LabelLists& farSide,
+                          Scratch& scratch,
+                          Visit&& visit) {
+        if(start < hub)
+            return;
+        for(auto [h, d]: hubSide[hub]) {
+            scratch.hubDist[h] = d;
+        }
+        scratch.queue.clear();
+        scratch.queue.push_back(start);
+        scratch.dist[start] = startDist;
+        for(int head = 0; head < scratch.queue.size(); head++) {
+            const int u = scratch.queue[head];
+            const int d = scratch.dist[u];
+            if(covered(scratch, farSide[u], d))
+                continue;
+            visit(u, d);
+            for(int w: adjacency[u]) {
+                if(w > hub && scratch.dist[w] < 0) {
+                    scratch.dist[w] = d + 1;
+                    scratch.queue.push_back(w);
+                }
+            }
+        }
+        for(int u: scratch.queue) {
+            scratch.dist[u] = -1;
+        }
+        for(auto [h, d]: hubSide[hub]) {
+            scratch.hubDist[h] = Unreachable;
+        }
+    }
+
+    // 插入或缩短 label 中 hub 对应的项
+    static void setEntry(std::vector<LabelEntry>& label, int hub, int dist) {
+        auto it = std::lower_bound(label.begin(), label.end(), hub,
+                                   [](const LabelEntry& e, int h) { return e.hub < h; });
+        if(it != label.end() && it->hub == hub)
+            it->dist = std::min(it->dist, dist);
+        else
+            label.insert(it, {hub, dist});
+    }
+
+    // 新边 a - b: a 的 reach 标签里的每个 hub 现在可以经过这条边到达 b,
+    // 从 b 沿 adjacency 继续剪枝 BFS 并写入 reach 标签
+    static void resumeFromEdge(int a,
+                               int b,
+                               LabelLists& reach,
+                               const LabelLists& hubSide,
+                               const Adjacency& adjacency,
+                               Scratch& scratch) {
+        // 后面的 BFS 会修改 reach, 先拷贝出要处理的 hub
+        const std::vector<LabelEntry> hubs = reach[a];
+        for(auto [hub, d]: hubs) {
+            prunedBfs(hub, b, d + 1, adjacency, hubSide, reach, scratch,
+                      [&](int u, int dist) { setEntry(reach[u], hub, dist); });
+        }
+    }
+
+    template <typename Sink>
+    static void writeArray(Sink& sink, const std::vector<int>& values) {
+        const uint64_t size = values.size();
+        sink.write({reinterpret_cast<const char*>(&size), sizeof(size)});
+        if(!values.empty())
+            sink.write({reinterpret_cast<const char*>(values.data()), values.size() * sizeof(int)});
+    }
+
+    static bool readExact(int fd, void* buf, size_t n) {
+        auto* p = static_cast<char*>(buf);
+        while(n > 0) {
+            auto got = ::read(fd, p, n);
+            if(got < 0 && errno == EINTR)
+                continue;
+            if(got <= 0)
+                return false;
+            p += got;
+            n -= got;
+        }
+        return true;
+    }
+
+    // 长度不能超过文件剩余的字节数, 损坏的长度字段不会触发巨大的分配
+    static bool readArray(int fd, uint64_t& remaining, std::vector<int>& values) {
+        uint64_t size;
+        if(remaining < sizeof(size) || !readExact(fd, &size, sizeof(size)))
+            return false;
+        remaining -= sizeof(size);
+        if(size > remaining / sizeof(int))
+            return false;
+        remaining -= size * sizeof(int);
+        values.resize(size);
+        return readExact(fd, values.data(), size * sizeof(int));
+    }
+
+    // fd 需位于文件开头, 只在这里取一次文件大小
+    int readFrom(int fd) {
+        struct stat st;
+        if(::fstat(fd, &st) != 0)
+            return errno;
+        uint64_t remaining = st.st_size;
+        char magic[Magic.size()];
+        std::vector<int> flags;
+        if(remaining < sizeof(magic) || !readExact(fd, magic, sizeof(magic))
+           || std::string_view(magic, sizeof(magic)) != Magic)
+            return EINVAL;
+        remaining -= sizeof(magic);
+        if(!readArray(fd, remaining, flags) || flags.size() != 1 || (flags[0] != 0 && flags[0] != 1)
+           || !readArray(fd, remaining, ids))
+            return EINVAL;
+        directed = flags[0];
+        for(Labels* labels: {&in, &out}) {
+            if(!readArray(fd, remaining, labels->offsets) || !readArray(fd, remaining, labels->hubs)
+               || !readArray(fd, remaining, labels->dists))
+                return EINVAL;
+        }
+        const int n = ids.size();
+        if(!in.valid(n) || (directed ? !out.valid(n) : !out.offsets.empty()))
+            return EINVAL;
+        forward.resize(n);
+        backward.resize(directed ? n : 0);
+        for(Adjacency* adjacency: {&forward, &backward}) {
+            for(auto& targets: *adjacency) {
+                if(!readArray(fd, remaining, targets)
+                   || std::any_of(targets.begin(), targets.end(), [n](int v) { return v < 0 || v >= n; }))
+                    return EINVAL;
+            }
+        }
+        for(int rank = 0; rank < n; rank++) {
+            if(!idToRank.emplace(ids[rank], rank).second)
+                return EINVAL;
+        }
+        return 0;
+    }
+};
+
+// 按排名分批构建, 每批 concurrency(policy) 个 hub 并行做剪枝 BFS, 只用前面批次的标签剪枝,
+// 批结束后再按排名顺序写入. 剪得少一些但距离仍然精确; seq 时就是顺序的 PLL
+template <execution::isExecutionPolicy P, isGraphView G>
+DistanceIndex buildDistanceIndex(const P& policy, const G& graph) {
+    using LabelLists = DistanceIndex::LabelLists;
+    using Scratch = DistanceIndex::Scratch;
+    constexpr bool directed = G::DirectednessTy::isDirected;
+
+    const CsrGraph csr = toCsr(graph);
+    const CsrGraph rev = directed ? transpose(csr) : CsrGraph{};
+    const int n = csr.numVertices();
+    auto totalDegree = [&](int v) { return csr.degree(v) + (directed ? rev.degree(v) : 0); };
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return totalDegree(a) > totalDegree(b); });
+    std::vector<int> rank(n);
+    for(int r = 0; r < n; r++) {
+        rank[order[r]] = r;
+    }
+
+    DistanceIndex index;
+    index.directed = directed;
+    index.ids.resize(n);
+    index.idToRank.reserve(n);
+    index.forward.resize(n);
+    index.backward.resize(directed ? n : 0);
+    for(int r = 0; r < n; r++) {
+        index.ids[r] = csr.ids[order[r]];
+        index.idToRank.emplace(index.ids[r], r);
+        for(int w: csr.neighbors(order[r])) {
+            index.forward[r].push_back(rank[w]);
+        }
+        if constexpr(directed) {
+            for(int w: rev.neighbors(order[r])) {
+                index.backward[r].push_back(rank[w]);
+            }
+        }
+    }
+
+    LabelLists inLists(n), outLists(directed ? n : 0);
+    LabelLists& outSide = directed ? outLists : inLists;
+    const int batchSize = parallel::concurrency(policy);
+    std::vector<std::vector<std::pair<int, int>>> foundIn(batchSize), foundOut(batchSize);
+    std::vector<Scratch> scratches;
+    for(int t = 0; t < batchSize; t++) {
+        scratches.emplace_back(n);
+    }
+    for(int first = 0; first < n; first += batchSize) {
+        const int last = std::min(n, first + batchSize);
+        // 每块处理一段连续的 hub, 用自己的工作区
+        parallel::forBlocks(policy, first, last, [&](int b, int lo, int hi) {
+            Scratch& scratch = scratches[b];
+            for(int hub = lo; hub < hi; hub++) {
+                auto& found = foundIn[hub - first];
+                found.clear();
+                DistanceIndex::prunedBfs(hub, hub, 0, index.forward, outSide, inLists, scratch,
+                                         [&](int u, int d) { found.emplace_back(u, d); });
+                if constexpr(directed) {
+                    auto& foundBack = foundOut[hub - first];
+                    foundBack.clear();
+                    DistanceIndex::prunedBfs(hub, hub, 0, index.backward, inLists, outLists,
+                                             scratch,
+                                             [&](int u, int d) { foundBack.emplace_back(u, d); });
+                }
+            }
+        });
+        for(int hub = first; hub < last; hub++) {
+            for(auto [u, d]: foundIn[hub - first]) {
+                inLists[u].push_back({hub, d});
+            }
+            if constexpr(directed) {
+                for(auto [u, d]: foundOut[hub - first]) {
+                    outLists[u].push_back({hub, d});
+                }
+            }
+        }
+    }
+    index.in = DistanceIndex::Labels(inLists);
+    if constexpr(directed)
+        index.out = DistanceIndex::Labels(outLists);
+    return index;
+}
+
+template <isGraphView G>
+DistanceIndex buildDistanceIndex(const G& graph) {
+    return buildDistanceIndex(execution::seq, graph);
+}
+
+}  // namespace GraphLib
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "csr.h"
+#include "data.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace GraphLib::algorithm {
+
+// 以下排序都返回新顺序下的顶点 id (下标即新编号), 有向图按忽略方向后的简单图计算
+
+inline std::vector<int> toIds(const CsrGraph& csr, const std::vector<int>& indices) {
+    std::vector<int> ids(indices.size());
+    for(int i = 0; i < indices.size(); i++) {
+        ids[i] = csr.ids[indices[i]];
+    }
+    return ids;
+}
+
+// 度数从大到小, 度数相同按 id
+inline std::vector<int> byDegreeDescending(const CsrGraph& adj) {
+    std::vector<int> order(adj.numVertices());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return adj.degree(a) > adj.degree(b);
+    });
+    return order;
+}
+
+// 从 start 开始 BFS, byDegree 为 true 时邻居按度数从小到大入队 (Cuthill-McKee)
+inline void bfsVisit(const CsrGraph& adj,
+                     int start,
+                     bool byDegree,
+                     std::vector<char>& visited,
+                     std::vector<int>& order) {
+    std::vector<int> neighbors;
+    size_t head = order.size();
+    visited[start] = true;
+    order.push_back(start);
+    while(head < order.size()) {
+        int v = order[head++];
+        neighbors.clear();
+        for(int u: adj.neighbors(v)) {
+            if(!visited[u]) {
+                visited[u] = true;
+                neighbors.push_back(u);
+            }
+        }
+        if(byDegree) {
+            std::stable_sort(neighbors.begin(), neighbors.end(), [&](int a, int b) {
+                return adj.degree(a) < adj.degree(b);
+            });
+        }
+        order.insert(order.end(), neighbors.begin(), neighbors.end());
+    }
+}
+
+template <isGraphView G>
+std::vector<int> degreeOrder(const G& graph) {
+    const CsrGraph adj = simpleUndirected(toCsr(graph));
+    return toIds(adj, byDegreeDescending(adj));
+}
+
+// 每个连通分量从度数最大的顶点开始 BFS
+template <isGraphView G>
+std::vector<int> bfsOrder(const G& graph) {
+    const CsrGraph adj = simpleUndirected(toCsr(graph));
+    std::vector<char> visited(adj.numVertices(), false);
+    std::vector<int> order;
+    order.reserve(adj.numVertices());
+    for(int start: byDegreeDescending(adj)) {
+        if(!visited[start])
+            bfsVisit(adj, start, false, visited, order);
+    }
+    return toIds(adj, order);
+}
+
+// Reverse Cuthill-McKee: 每个连通分量从度数最小的顶点开始, 最后整体反转
+template <isGraphView G>
+std::vector<int> rcmOrder(const G& graph) {
+    const CsrGraph adj = simpleUndirected(toCsr(graph));
+    auto starts = byDegreeDescending(adj);
+    std::reverse(starts.begin(), starts.end());
+    std::vector<char> visited(adj.numVertices(), false);
+    std::vector<int> order;
+    order.reserve(adj.numVertices());
+    for(int start: starts) {
+        if(!visited[start])
+            bfsVisit(adj, start, true, visited, order);
+    }
+    std::reverse(order.begin(), order.end());
+    return toIds(adj, order);
+}
+
+// 类 Gorder 的贪心: 每次挑与最近 window 个已放置顶点关系最紧的顶点, 关系分数为
+// 直接相邻数加共同邻居数. 度数超过 hubDegree 的顶点不展开共同邻居, 避免枢纽顶点拖慢.
+// 分数每次只加减 1, 和原算法一样按分数分桶存放未放置的顶点 (每桶一条双向链表),
+// 取最大值只需从上次的最高分往下找非空桶, 内存为 O(n + 最高分)
+template <isGraphView G>
+std::vector<int> gorderOrder(const G& graph, int window = 5) {
+    const CsrGraph adj = simpleUndirected(toCsr(graph));
+    const int n = adj.numVertices();
+    const int hubDegree = std::max(16, int(std::sqrt(double(n))));
+    std::vector<int> score(n, 0);
+    std::vector<char> placed(n, false);
+    // 分数为正的未放置顶点在 bucket[score] 链表中, 分数为 0 的不在任何桶里
+    std::vector<int> bucket(1, -1), prev(n, -1), next(n, -1);
+    int top = 0;
+
+    auto unlink = [&](int u) {
+        if(prev[u] >= 0)
+            next[prev[u]] = next[u];
+        else
+            bucket[score[u]] = next[u];
+        if(next[u] >= 0)
+            prev[next[u]] = prev[u];
+    };
+    auto link = [&](int u) {
+        const int s = score[u];
+        if(s >= bucket.size())
+            bucket.resize(s + 1, -1);
+        prev[u] = -1;
+        next[u] = bucket[s];
+        if(next[u] >= 0)
+            prev[next[u]] = u;
+        bucket[s] = u;
+        top = std::max(top, s);
+    };
+    auto bump = [&](int u, int delta) {
+        if(placed[u])
+            return;
+        if(score[u] > 0)
+            unlink(u);
+        score[u] += delta;
+        if(score[u] > 0)
+            link(u);
+    };
+    auto relate = [&](int v, int delta) {
+        for(int u: adj.neighbors(v)) {
+            bump(u, delta);
+            if(adj.degree(u) > hubDegree)
+                continue;
+            for(int w: adj.neighbors(u)) {
+                if(w != v)
+                    bump(w, delta);
+            }
+        }
+    };
+
+    const auto fallback = byDegreeDescending(adj);
+    int nextFallback = 0;
+    std::vector<int> order;
+    order.reserve(n);
+    while(order.size() < n) {
+        while(top > 0 && bucket[top] < 0)
+            top--;
+        int chosen = -1;
+        if(top > 0) {
+            chosen = bucket[top];
+            unlink(chosen);
+        }
+        while(chosen < 0) {
+            int u = fallback[nextFallback++];
+            if(!placed[u])
+                chosen = u;
+        }
+        placed[chosen] = true;
+        order.push_back(chosen);
+        relate(chosen, 1);
+        if(order.size() > window)
+            relate(order[order.size() - window - 1], -1);
+    }
+    return toIds(adj, order);
+}
+
+template <isVertex V>
+struct Relabeling {
+    GraphData<V> data;     // 顶点编号为 0..n-1, 边按新的起点编号排列
+    Renumbering mapping;   // 新 id -> 原始 id
+};
+
+// 按 order (新编号 -> 原 id) 生成重新编号的图. order 必须是全部顶点的一个排列
+template <isVertex V, isDirectedness D>
+Relabeling<V> relabel(const Graph<V, D>& graph, const std::vector<int>& order) {
+    Renumbering mapping;
+    mapping.vertexIds = order;
+    std::unordered_map<int, int> newId;
+    newId.reserve(order.size());
+    for(int i = 0; i < order.size(); i++) {
+        if(!newId.emplace(order[i], i).second)
+            throw std::runtime_error("Vertex order contains duplicate ids");
+    }
+    int found = 0, total = 0;
+    graph.forEachVertex([&](const V& v) {
+        found += newId.count(v.id);
+        total++;
+    });
+    if(found != total || found != order.size())
+        throw std::runtime_error("Vertex order is not a permutation of the graph vertices");
+
+    std::vector<std::tuple<int, int, int>> edges;  // (新起点, 新终点, 原边 id)
+    edges.reserve(graph.numEdges());
+    graph.forEachEdge([&](const Edge& e) {
+        // 指向未添加顶点的边, 把端点排在最后
+        for(int end: {e.from, e.to}) {
+            if(newId.emplace(end, mapping.vertexIds.size()).second)
+                mapping.vertexIds.push_back(end);
+        }
+        edges.emplace_back(newId.at(e.from), newId.at(e.to), e.id);
+    });
+    std::sort(edges.begin(), edges.end());
+    mapping.edgeIds.reserve(edges.size());
+    for(const auto& [from, to, id]: edges) {
+        mapping.edgeIds.push_back(id);
+    }
+    return {graph.relabeled(mapping), std::move(mapping)};
+}
+
+// 排序都是一次贪心扫描, 没有并行版本; 接受执行策略以便与其它算法统一调用
+template <execution::isExecutionPolicy P, isGraphView G>
+std::vector<int> degreeOrder(const P&, const G& graph) {
+    return degreeOrder(graph);
+}
+
+template <execution::isExecutionPolicy P, isGraphView G>
+std::vector<int> bfsOrder(const P&, const G& graph) {
+    return bfsOrder(graph);
+}
+
+template <execution::isExecutionPolicy P, isGraphView G>
+std::vector<int> rcmOrder(const P&, const G& graph) {
+    return rcmOrder(graph);
+}
+
+template <execution::isExecutionPolicy P, isGraphView G>
+std::vector<int> gorderOrder(const P&, const G& graph, int window = 5) {
+    return gorderOrder(graph, window);
+}
+
+template <execution::isExecutionPolicy P, isVertex V, isDirectedness D>
+Relabeling<V> relabel(const P&, const Graph<V, D>& graph, const std::vector<int>& order) {
+    return relabel(graph, order);
+}
+
+}  // namespace GraphLib::algorithm
@@ -0,0 +1,429 @@
+#pragma once
+
+#include "csr.h"
+#include "data.h"
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+namespace GraphLib::algorithm {
+
+// 强连通分量. 分量按凝聚图的拓扑序编号, 凝聚图的边总是从小编号指向大编号
+struct StrongComponents {
+    std::vector<int> ids;        // 按 id 排序
+    std::vector<int> component;  // 与 ids 对齐
+    int numComponents = 0;
+    // 顶点 i 是第 i 个分量, 每条边的 weight 是被合并的原边数, 不含 edgeIds
+    CsrGraph condensation;
+
+    // 顶点不在图中时返回 -1
+    [[nodiscard]] int componentOf(int id) const {
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if(it == ids.end() || *it != id)
+            return -1;
+        return component[it - ids.begin()];
+    }
+};
+
+namespace detail {
+
+    // 迭代版 Pearce 算法, 只走 active 的顶点, 依次从 roots 中还没访问过的顶点出发.
+    // rindex 为 0 表示未访问, 算完的顶点置为 INT_MAX.
+    // 每找到一个分量调用 emit(成员), 分量按逆拓扑序给出
+    template <typename Active, typename Emit>
+    void pearceScc(const CsrGraph& csr,
+                   const std::vector<int>& roots,
+                   Active&& active,
+                   std::vector<int>& rindex,
+                   Emit&& emit) {
+        struct Frame {
+            int v;
+            int pos;  // 下一条要看的出边
+            bool root;
+        };
+        std::vector<Frame> frames;
+        std::vector<int> stack, members;
+        int index = 1;
+        for(int r: roots) {
+            if(rindex[r] != 0)
+                continue;
+            rindex[r] = index++;
+            frames.push_back({r, csr.offsets[r], true});
+            while(!frames.empty()) {
+                Frame& f = frames.back();
+                const int v = f.v;
+                bool descended = false;
+                for(; f.pos < csr.offsets[v + 1]; f.pos++) {
+                    const int w = csr.targets[f.pos];
+                    if(!active(w))
+                        continue;
+                    if(rindex[w] == 0) {
+                        // 不前移 pos, 回来时再看一次 w 以合并它的 rindex
+                        rindex[w] = index++;
+                        frames.push_back({w, csr.offsets[w], true});
+                        descended = true;
+                        break;
+                    }
+                    if(rindex[w] < rindex[v]) {
+                        rindex[v] = rindex[w];
+                        f.root = false;
+                    }
+                }
+                if(descended)
+                    continue;
+                const bool root = f.root;
+                frames.pop_back();
+                if(!root) {
+                    stack.push_back(v);
+                    continue;
+                }
+                members.clear();
+                members.push_back(v);
+                while(!stack.empty() && rindex[v] <= rindex[stack.back()]) {
+                    rindex[stack.back()] = INT_MAX;
+                    members.push_back(stack.back());
+                    stack.pop_back();
+                }
+                rindex[v] = INT_MAX;
+                emit(members);
+            }
+        }
+    }
+
+    // 按 component 合并 csr 的边, 得到凝聚图
+    inline CsrGraph condense(const CsrGraph& csr, const std::vector<int>& component, int k) {
+        CsrGraph dag;
+        dag.ids.resize(k);
+        dag.idToIndex.reserve(k);
+        for(int c = 0; c < k; c++) {
+            dag.ids[c] = c;
+            dag.idToIndex.emplace(c, c);
+        }
+        std::vector<int> start(k + 1, 0);
+        for(int v = 0; v < csr.numVertices(); v++) {
+            for(int w: csr.neighbors(v)) {
+                if(component[v] != component[w])
+                    start[component[v] + 1]++;
+            }
+        }
+        for(int c = 0; c < k; c++) {
+            start[c + 1] += start[c];
+        }
+        std::vector<int> arcs(start[k]);
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for(int v = 0; v < csr.numVertices(); v++) {
+            for(int w: csr.neighbors(v)) {
+                if(component[v] != component[w])
+                    arcs[fill[component[v]]++] = component[w];
+            }
+        }
+        dag.offsets.assign(k + 1, 0);
+        for(int c = 0; c < k; c++) {
+            std::sort(arcs.begin() + start[c], arcs.begin() + start[c + 1]);
+            for(int i = start[c]; i < start[c + 1]; i++) {
+                if(i > start[c] && arcs[i] == arcs[i - 1]) {
+                    dag.weights.back()++;
+                    continue;
+                }
+                dag.targets.push_back(arcs[i]);
+                dag.weights.push_back(1);
+            }
+            dag.offsets[c + 1] = dag.targets.size();
+        }
+        return dag;
+    }
+
+    // 在 alive 的顶点中从 pivot 出发逐层并行 BFS, 到达的顶点 reached 置 1
+    template <execution::isExecutionPolicy P>
+    void parallelReach(const P& policy,
+                       const CsrGraph& adj,
+                       int pivot,
+                       const std::vector<char>& alive,
+                       std::vector<std::atomic<char>>& reached) {
+        std::vector<int> frontier{pivot};
+        reached[pivot].store(1, std::memory_order_relaxed);
+        std::vector<std::vector<int>> nextParts(parallel::concurrency(policy));
+        while(!frontier.empty()) {
+            parallel::forBlocks(policy, 0, frontier.size(), [&](int b, int lo, int hi) {
+                auto& next = nextParts[b];
+                for(int i = lo; i < hi; i++) {
+                    for(int w: adj.neighbors(frontier[i])) {
+                        if(alive[w] && !reached[w].load(std::memory_order_relaxed)
+                           && !reached[w].exchange(1, std::memory_order_relaxed))
+                            next.push_back(w);
+                    }
+                }
+            });
+            frontier.clear();
+            for(auto& next: nextParts) {
+                frontier.insert(frontier.end(), next.begin(), next.end());
+                next.clear();
+            }
+        }
+    }
+
+    // 反复剥掉 alive 中入度或出度为 0 的顶点 (不计自环), 每个剥掉的顶点单独成为一个分量
+    template <execution::isExecutionPolicy P>
+    void parallelTrim(const P& policy,
+                      const CsrGraph& out,
+                      const CsrGraph& in,
+                      std::vector<char>& alive,
+                      std::vector<int>& component,
+                      int& numComponents) {
+        const int n = out.numVertices();
+        std::vector<std::atomic<int>> inDeg(n), outDeg(n);
+        auto liveDegree = [&](const CsrGraph& adj, int v) {
+            int d = 0;
+            for(int w: adj.neighbors(v)) {
+                d += alive[w] && w != v;
+            }
+            return d;
+        };
+        std::vector<std::vector<int>> parts(parallel::concurrency(policy));
+        parallel::forBlocks(policy, 0, n, [&](int b, int lo, int hi) {
+            for(int v = lo; v < hi; v++) {
+                if(!alive[v])
+                    continue;
+                inDeg[v].store(liveDegree(in, v), std::memory_order_relaxed);
+                outDeg[v].store(liveDegree(out, v), std::memory_order_relaxed);
+                if(inDeg[v].load(std::memory_order_relaxed) == 0
+                   || outDeg[v].load(std::memory_order_relaxed) == 0)
+                    parts[b].push_back(v);
+            }
+        });
+        std::vector<int> frontier;
+        while(true) {
+            frontier.clear();
+            for(auto& part: parts) {
+                for(int v: part) {
+                    // 入度和出度可能同时减到 0, 同一个顶点会出现两次
+                    if(alive[v]) {
+                        alive[v] = false;
+                        component[v] = numComponents++;
+                        frontier.push_back(v);
+                    }
+                }
+                part.clear();
+            }
+            if(frontier.empty())
+                break;
+            parallel::forBlocks(policy, 0, frontier.size(), [&](int b, int lo, int hi) {
+                for(int i = lo; i < hi; i++) {
+                    const int v = frontier[i];
+                    for(int w: out.neighbors(v)) {
+                        if(alive[w] && w != v && inDeg[w].fetch_sub(1, std::memory_order_relaxed) == 1)
+                            parts[b].push_back(w);
+                    }
+                    for(int w: in.neighbors(v)) {
+                        if(alive[w] && w != v && outDeg[w].fetch_sub(1, std::memory_order_relaxed) == 1)
+                            parts[b].push_back(w);
+                    }
+                }
+            });
+        }
+    }
+
+    // 并发并查集, 总是把大编号的根挂到小编号的根下
+    inline int findRoot(std::vector<std::atomic<int>>& parent, int x) {
+        while(true) {
+            int p = parent[x].load(std::memory_order_relaxed);
+            if(p == x)
+                return x;
+            int gp = parent[p].load(std::memory_order_relaxed);
+            if(p != gp)
+                parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+            x = gp;
+        }
+    }
+
+    inline void unite(std::vector<std::atomic<int>>& parent, int a, int b) {
+        while(true) {
+            a = findRoot(parent, a);
+            b = findRoot(parent, b);
+            if(a == b)
+                return;
+            if(a < b)
+                std::swap(a, b);
+            int expected = a;
+            if(parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    // 按凝聚图的拓扑序 (Kahn) 重新编号分量
+    inline void topologicalRenumber(const CsrGraph& csr, std::vector<int>& component, int k) {
+        const CsrGraph dag = condense(csr, component, k);
+        std::vector<int> inDeg(k, 0);
+        for(int w: dag.targets) {
+            inDeg[w]++;
+        }
+        std::vector<int> order;
+        order.reserve(k);
+        for(int c = 0; c < k; c++) {
+            if(inDeg[c] == 0)
+                order.push_back(c);
+        }
+        for(int head = 0; head < order.size(); head++) {
+            for(int w: dag.neighbors(order[head])) {
+                if(--inDeg[w] == 0)
+                    order.push_back(w);
+            }
+        }
+        std::vector<int> newId(k);
+        for(int i = 0; i < k; i++) {
+            newId[order[i]] = i;
+        }
+        for(int& c: component) {
+            c = newId[c];
+        }
+    }
+
+}  // namespace detail
+
+// 单线程的迭代 Pearce 算法, 适合中小规模的图; 无向图得到的就是连通分量
+template <isGraphView G>
+StrongComponents stronglyConnectedComponents(const G& graph) {
+    const CsrGraph csr = toCsr(graph);
+    const int n = csr.numVertices();
+    StrongComponents result;
+    result.ids = csr.ids;
+    result.component.resize(n);
+    std::vector<int> roots(n), rindex(n, 0);
+    for(int v = 0; v < n; v++) {
+        roots[v] = v;
+    }
+    int k = 0;
+    detail::pearceScc(
+        csr, roots, [](int) { return true; }, rindex,
+        [&](const std::vector<int>& members) {
+            for(int v: members) {
+                result.component[v] = k;
+            }
+            k++;
+        });
+    // 分量是按逆拓扑序找到的
+    for(int& c: result.component) {
+        c = k - 1 - c;
+    }
+    result.numComponents = k;
+    result.condensation = detail::condense(csr, result.component, k);
+    return result;
+}
+
+// seq 时用上面的 Pearce 算法. 并行时面向大图:
+// 1. 并行剥掉入度或出度为 0 的顶点;
+// 2. 从入度与出度乘积最大的顶点做一次并行前向/后向 BFS, 交集就是 (通常是巨大的) 那个分量;
+// 3. 再剥一次, 剩下的顶点按弱连通分量分组, 各组由线程池窃取执行, 组内用 Pearce 算法
+template <execution::isExecutionPolicy P, isGraphView G>
+StrongComponents stronglyConnectedComponents(const P& policy, const G& graph) {
+    if constexpr(execution::isSequenced<P>) {
+        return stronglyConnectedComponents(graph);
+    } else {
+        const CsrGraph out = toCsr(graph);
+        const CsrGraph in = transpose(out);
+        const int n = out.numVertices();
+        StrongComponents result;
+        result.ids = out.ids;
+        result.component.assign(n, -1);
+        std::vector<char> alive(n, true);
+        int k = 0;
+
+        detail::parallelTrim(policy, out, in, alive, result.component, k);
+
+        int pivot = -1;
+        int64_t best = -1;
+        for(int v = 0; v < n; v++) {
+            if(alive[v] && int64_t(out.degree(v)) * in.degree(v) > best) {
+                best = int64_t(out.degree(v)) * in.degree(v);
+                pivot = v;
+            }
+        }
+        if(pivot >= 0) {
+            std::vector<std::atomic<char>> forward(n), backward(n);
+            detail::parallelReach(policy, out, pivot, alive, forward);
+            detail::parallelReach(policy, in, pivot, alive, backward);
+            for(int v = 0; v < n; v++) {
+                if(forward[v].load(std::memory_order_relaxed)
+                   && backward[v].load(std::memory_order_relaxed)) {
+                    alive[v] = false;
+                    result.component[v] = k;
+                }
+            }
+            k++;
+            detail::parallelTrim(policy, out, in, alive, result.component, k);
+        }
+
+        std::vector<std::atomic<int>> parent(n);
+        for(int v = 0; v < n; v++) {
+            parent[v].store(v, std::memory_order_relaxed);
+        }
+        parallel::parallelFor(policy, 0, n, [&](int lo, int hi) {
+            for(int v = lo; v < hi; v++) {
+                if(!alive[v])
+                    continue;
+                for(int w: out.neighbors(v)) {
+                    if(alive[w])
+                        detail::unite(parent, v, w);
+                }
+            }
+        });
+        // 按并查集的根分组, 每组的顶点在 members 中连续存放
+        std::vector<int> groupOf(n, -1), groupStart{0}, members;
+        for(int v = 0; v < n; v++) {
+            if(alive[v] && detail::findRoot(parent, v) == v) {
+                groupOf[v] = groupStart.size() - 1;
+                groupStart.push_back(0);
+            }
+        }
+        const int numGroups = groupStart.size() - 1;
+        for(int v = 0; v < n; v++) {
+            if(alive[v])
+                groupStart[groupOf[detail::findRoot(parent, v)] + 1]++;
+        }
+        for(int g = 0; g < numGroups; g++) {
+            groupStart[g + 1] += groupStart[g];
+        }
+        members.resize(groupStart[numGroups]);
+        std::vector<int> fill(groupStart.begin(), groupStart.end() - 1);
+        for(int v = 0; v < n; v++) {
+            if(alive[v])
+                members[fill[groupOf[detail::findRoot(parent, v)]]++] = v;
+        }
+
+        std::vector<int> rindex(n, 0);
+        std::atomic<int> nextComponent{k};
+        // 每组一个任务, 大小悬殊的组靠工作窃取平衡
+        parallel::parallelFor(
+            policy,
+            0,
+            numGroups,
+            [&](int lo, int hi) {
+                std::vector<int> roots;
+                for(int g = lo; g < hi; g++) {
+                    roots.assign(members.begin() + groupStart[g],
+                                 members.begin() + groupStart[g + 1]);
+                    // 组内的存活邻居一定属于同一组, 各任务写的 rindex 与 component 互不相交
+                    detail::pearceScc(
+                        out, roots, [&](int w) { return bool(alive[w]); }, rindex,
+                        [&](const std::vector<int>& scc) {
+                            const int c = nextComponent.fetch_add(1, std::memory_order_relaxed);
+                            for(int v: scc) {
+                                result.component[v] = c;
+                            }
+                        });
+                }
+            },
+            1);
+        k = nextComponent.load();
+
+        detail::topologicalRenumber(out, result.component, k);
+        result.numComponents = k;
+        result.condensation = detail::condense(out, result.component, k);
+        return result;
+    }
+}
+
+}  // namespace GraphLib::algorithm
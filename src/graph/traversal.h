@@ -0,0 +1,106 @@
+#pragma once
+
+#include "data.h"
+#include "generator.h"
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// 惰性遍历: 每次只推进到下一个结果, 调用方可以随时停下, 没走到的部分不付代价.
+// 生成器引用 graph, 遍历期间 graph 必须存活且不能被修改
+namespace GraphLib::algorithm {
+
+// 逐层产出 BFS 的顶点, 第 0 层是 source. source 不在图中时什么也不产出
+template <isGraphView G>
+Generator<std::vector<int>> bfsLevels(const G& graph, int source) {
+    if(!graph.getEdgeIdsOfVertex(source))
+        co_return;
+    std::unordered_set<int> visited{source};
+    std::vector<int> level{source}, next;
+    while(!level.empty()) {
+        co_yield level;
+        next.clear();
+        for(int v: level) {
+            auto edgeIds = graph.getEdgeIdsOfVertex(v);
+            if(!edgeIds)
+                continue;
+            for(int edgeId: *edgeIds) {
+                int u = graph.getEdge(edgeId).other(v);
+                if(visited.insert(u).second)
+                    next.push_back(u);
+            }
+        }
+        level.swap(next);
+    }
+}
+
+// 距离 source 不超过 k 跳的顶点 (不含 source), 按 BFS 顺序逐个产出 (顶点, 跳数)
+template <isGraphView G>
+Generator<std::pair<int, int>> kHopNeighborhood(const G& graph, int source, int k) {
+    if(!graph.getEdgeIdsOfVertex(source))
+        co_return;
+    std::unordered_set<int> visited{source};
+    std::vector<std::pair<int, int>> queue{{source, 0}};
+    for(size_t head = 0; head < queue.size(); head++) {
+        auto [v, hops] = queue[head];
+        if(hops == k)
+            continue;
+        auto edgeIds = graph.getEdgeIdsOfVertex(v);
+        if(!edgeIds)
+            continue;
+        for(int edgeId: *edgeIds) {
+            int u = graph.getEdge(edgeId).other(v);
+            if(!visited.insert(u).second)
+                continue;
+            queue.emplace_back(u, hops + 1);
+            co_yield std::pair<int, int>{u, hops + 1};
+        }
+    }
+}
+
+// 迭代式 DFS, 显式栈保存每个顶点剩余的边, postorder 为 false 时产出先序, 否则产出后序
+template <isGraphView G>
+Generator<int> dfs(const G& graph, int source, bool postorder) {
+    auto rootEdges = graph.getEdgeIdsOfVertex(source);
+    if(!rootEdges)
+        co_return;
+    struct Frame {
+        int vertex;
+        std::vector<int> edgeIds;
+        size_t next = 0;
+    };
+    std::unordered_set<int> visited{source};
+    std::vector<Frame> stack;
+    stack.push_back({source, std::move(*rootEdges)});
+    if(!postorder)
+        co_yield source;
+    while(!stack.empty()) {
+        auto& frame = stack.back();
+        if(frame.next == frame.edgeIds.size()) {
+            int v = frame.vertex;
+            stack.pop_back();
+            if(postorder)
+                co_yield v;
+            continue;
+        }
+        int u = graph.getEdge(frame.edgeIds[frame.next++]).other(frame.vertex);
+        if(!visited.insert(u).second)
+            continue;
+        auto edgeIds = graph.getEdgeIdsOfVertex(u);
+        stack.push_back({u, edgeIds ? std::move(*edgeIds) : std::vector<int>{}});
+        if(!postorder)
+            co_yield u;
+    }
+}
+
+template <isGraphView G>
+Generator<int> dfsPreorder(const G& graph, int source) {
+    return dfs(graph, source, false);
+}
+
+template <isGraphView G>
+Generator<int> dfsPostorder(const G& graph, int source) {
+    return dfs(graph, source, true);
+}
+
+}  // namespace GraphLib::algorithm
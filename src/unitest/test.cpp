@@ -1,7 +1,24 @@
 #include "./algorithm.h"
+#include "./cache.h"
 #include "./data.h"
+#include "./export.h"
+#include "./flow.h"
+#include "./kcore.h"
+#include "./msbfs.h"
+#include "./pagerank.h"
+#include "./parallel.h"
+#include "./partition.h"
+#include "./pll.h"
+#include "./reorder.h"
+#include "./scc.h"
+#include "./traversal.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <mutex>
 #include <print>
+#include <sstream>
 
 // 基础测试：空图
 using namespace GraphLib;
@@ -90,6 +107,34 @@ TEST(GraphTest, GetDataOfVertex) {
     EXPECT_FALSE(data3.has_value());  // 顶点不存在
 }
 
+// 无向图：每条边只存一份，两个端点共享
+TEST(GraphTest, UndirectedEdgeStorage) {
+    UndirectedGraph<Vertex<void>> g;
+    for(int i = 1; i <= 4; i++) {
+        g.addVertex(Vertex<void>(i));
+    }
+    g.addEdge(Edge(1, 1, 2));
+    g.addEdge(Edge(2, 2, 3));
+    g.addEdge(Edge(3, 3, 4));
+    EXPECT_EQ(3, g.numEdges());
+    EXPECT_EQ(std::vector<int>{1}, *g.getEdgeIdsOfVertex(1));
+    EXPECT_EQ(2, g.getEdgeIdsOfVertex(2)->size());
+
+    EXPECT_TRUE(g.delEdge(1));
+    EXPECT_EQ(2, g.numEdges());
+    EXPECT_TRUE(g.getEdgeIdsOfVertex(1)->empty());
+    EXPECT_EQ(std::vector<int>{2}, *g.getEdgeIdsOfVertex(2));
+
+    EXPECT_TRUE(g.delVertex(3));
+    EXPECT_EQ(0, g.numEdges());
+    EXPECT_TRUE(g.getEdgeIdsOfVertex(2)->empty());
+    EXPECT_TRUE(g.getEdgeIdsOfVertex(4)->empty());
+
+    UndirectedGraph<Vertex<void>> comp = g.complement();
+    EXPECT_EQ(3, comp.numVertices());
+    EXPECT_EQ(3, comp.numEdges());
+}
+
 // 测试 Tarjan 算法
 TEST(GraphTest, Tarjan) {
     UndirectedGraph<Vertex<void>> g;
@@ -184,6 +229,22 @@ TEST(GraphTest, BFS) {
     EXPECT_EQ(3, distExp);
     auto distExp2 = GraphLib::algorithm::distanceWithoutWeight(g, 1, 5);
     EXPECT_EQ(2, distExp2);
+
+    // 第二层的 2 和 3 互相连边: 先出队的那个处理邻居时, 另一个已在队列中, 距离不能被改成 3.
+    // 4 只能经 3 到达, 5 只能经 2 到达, 无论出队顺序如何总有一个查询会受影响
+    Graph<Vertex<void>> dg;
+    for(int i = 0; i <= 5; i++) {
+        dg.addVertex(Vertex<void>(i));
+    }
+    dg.addEdge(Edge(0, 0, 1));
+    dg.addEdge(Edge(1, 1, 2));
+    dg.addEdge(Edge(2, 1, 3));
+    dg.addEdge(Edge(3, 2, 3));
+    dg.addEdge(Edge(4, 3, 2));
+    dg.addEdge(Edge(5, 3, 4));
+    dg.addEdge(Edge(6, 2, 5));
+    EXPECT_EQ(3, GraphLib::algorithm::distanceWithoutWeight(dg, 0, 4));
+    EXPECT_EQ(3, GraphLib::algorithm::distanceWithoutWeight(dg, 0, 5));
 }
 
 // 子图
@@ -214,4 +275,1035 @@ TEST(GraphTest, Subgraph) {
     EXPECT_EQ(20, subG2.getVertex(2).data);
     EXPECT_EQ(30, subG2.getVertex(3).data);
     EXPECT_EQ(50, subG2.getVertex(5).data);
+
+    // 4 和 5 在 subG2 中只作终点, 没有邻接表, 视图仍要保留它们
+    auto sinkView = subG2.viewOfVertices({1, 3, 4, 5});
+    EXPECT_EQ(4, sinkView.numVertices());
+    EXPECT_TRUE(sinkView.containsVertex(5));
+    EXPECT_EQ(2, sinkView.numEdges());
+    EXPECT_TRUE(sinkView.getEdgeIdsOfVertex(4)->empty());
+    auto sinkData = sinkView.materialize();
+    EXPECT_EQ(4, sinkData.idToVertex.size());
+    EXPECT_EQ(2, sinkData.idToEdge.size());
+    EXPECT_EQ(50, sinkView.getVertex(5).data);
+}
+
+// 惰性子图视图
+TEST(GraphTest, SubgraphView) {
+    using MVertex = Vertex<int>;
+    UndirectedGraph<MVertex> g;
+    for(int i = 1; i <= 6; i++) {
+        g.addVertex(MVertex(i, i * 10));
+    }
+    g.addEdge(Edge(1, 1, 2));
+    g.addEdge(Edge(2, 2, 3));
+    g.addEdge(Edge(3, 3, 4));
+    g.addEdge(Edge(4, 4, 5));
+    g.addEdge(Edge(5, 1, 5));
+    g.addEdge(Edge(6, 5, 6));
+
+    // 顶点视图: 去掉 5 之后 1 到 4 只能绕 2, 3
+    auto view = g.viewOfVertices({1, 2, 3, 4, 42});
+    EXPECT_EQ(4, view.numVertices());
+    EXPECT_EQ(3, view.numEdges());
+    EXPECT_FALSE(view.containsVertex(5));
+    EXPECT_FALSE(view.getEdgeIdsOfVertex(5).has_value());
+    EXPECT_EQ(30, **view.getDataOfVertex(3));
+    EXPECT_EQ(3, GraphLib::algorithm::distanceWithoutWeight(view, 1, 4));
+    EXPECT_EQ(2, GraphLib::algorithm::distanceWithoutWeight(g, 1, 4));
+    auto cuts = GraphLib::algorithm::tarjan(view);
+    std::sort(cuts.begin(), cuts.end());
+    EXPECT_EQ((std::vector<int>{2, 3}), cuts);
+
+    // 边视图
+    auto edgeView = g.viewOfEdges({1, 5, 6});
+    EXPECT_EQ(4, edgeView.numVertices());
+    EXPECT_EQ(3, edgeView.numEdges());
+    EXPECT_EQ(3, GraphLib::algorithm::distanceWithoutWeight(edgeView, 2, 6));
+
+    UndirectedGraph<MVertex> sub = view.materialize();
+    EXPECT_EQ(4, sub.numVertices());
+    EXPECT_EQ(3, sub.numEdges());
+    EXPECT_EQ(40, sub.getVertex(4).data);
+}
+
+// 流式导出
+TEST(GraphTest, Export) {
+    using MVertex = Vertex<std::string>;
+    Graph<MVertex> g;
+    g.addVertex(MVertex(1, "a\"b"));
+    g.addEdge(Edge(7, 1, 1, 3));
+
+    auto exportTo = [&](GraphLib::io::ExportFormat format) {
+        std::ostringstream os;
+        {
+            GraphLib::io::BufferedSink<GraphLib::io::OstreamWriter, 8> sink({os});
+            GraphLib::io::write(g, sink, format);
+        }
+        return os.str();
+    };
+    EXPECT_EQ("1 1 3\n", exportTo(GraphLib::io::ExportFormat::EdgeList));
+    EXPECT_EQ("digraph {\n  1 [label=\"a\\\"b\"];\n  1 -> 1 [id=7, weight=3];\n}\n",
+              exportTo(GraphLib::io::ExportFormat::Dot));
+    EXPECT_EQ("{\"directed\":true,\"vertices\":[{\"id\":1,\"data\":\"a\\\"b\"}],"
+              "\"edges\":[{\"id\":7,\"from\":1,\"to\":1,\"weight\":3}]}\n",
+              exportTo(GraphLib::io::ExportFormat::Json));
+    EXPECT_NE(std::string::npos,
+              exportTo(GraphLib::io::ExportFormat::GraphML)
+                  .find("<node id=\"n1\"><data key=\"data\">a&quot;b</data></node>"));
+
+    // GraphML 中不允许的控制字符被替换, 制表符和换行保留
+    g.addVertex(MVertex(2, std::string("x\x01y\tz\n\x1f")));
+    EXPECT_NE(std::string::npos,
+              exportTo(GraphLib::io::ExportFormat::GraphML)
+                  .find("<node id=\"n2\"><data key=\"data\">"
+                        "x\xEF\xBF\xBDy\tz\n\xEF\xBF\xBD</data></node>"));
+
+    UndirectedGraph<Vertex<void>> ug;
+    for(int i = 0; i < 1000; i++) {
+        ug.addVertex(Vertex<void>(i));
+        if(i > 0)
+            ug.addEdge(Edge(i, i - 1, i));
+    }
+    std::ostringstream os;
+    {
+        GraphLib::io::BufferedSink<GraphLib::io::OstreamWriter, 64> sink({os});
+        GraphLib::io::writeEdgeList(ug.viewOfVertices({0, 1, 2, 3}), sink);
+        GraphLib::io::writeEdgeList(ug, sink);
+    }
+    auto text = os.str();
+    EXPECT_EQ(3 + 999, std::count(text.begin(), text.end(), '\n'));
+}
+
+// 内存统计与压缩
+TEST(GraphTest, MemoryUsageAndCompact) {
+    using MVertex = Vertex<std::vector<int>>;
+    Graph<MVertex> g;
+    for(int i = 0; i < 2000; i++) {
+        g.addVertex(MVertex(i * 3, std::vector<int>(4, i)));
+    }
+    for(int i = 1; i < 2000; i++) {
+        g.addEdge(Edge(i * 5, (i - 1) * 3, i * 3, i));
+    }
+    auto before = g.memoryUsage();
+    EXPECT_GE(before.vertexData, 2000 * 4 * sizeof(int));
+    EXPECT_EQ(before.total(),
+              before.adjacency + before.vertexMap + before.edgeMap + before.vertexData);
+
+    for(int i = 10; i < 2000; i++) {
+        g.delVertex(i * 3);
+    }
+    auto churned = g.memoryUsage();
+    g.compact();
+    auto compacted = g.memoryUsage();
+    EXPECT_LT(compacted.adjacency, churned.adjacency);
+    EXPECT_LT(compacted.total(), churned.total());
+    EXPECT_EQ(10, g.numVertices());
+    EXPECT_EQ(9, g.numEdges());
+
+    // 重新编号时顶点 data 被移走而不是拷贝, 原来的缓冲区被新顶点接管
+    const int* buffer = g.getVertex(27).data.data();
+    auto mapping = g.compact(true);
+    EXPECT_EQ(buffer, g.getVertex(9).data.data());
+    EXPECT_EQ(10, mapping.vertexIds.size());
+    EXPECT_EQ(9, mapping.edgeIds.size());
+    EXPECT_EQ(27, mapping.vertexIds[9]);
+    EXPECT_EQ(45, mapping.edgeIds[8]);
+    EXPECT_EQ(9, g.getVertex(9).data[0]);
+    const auto& last = g.getEdge(8);
+    EXPECT_EQ(8, last.from);
+    EXPECT_EQ(9, last.to);
+    EXPECT_EQ(9, last.weight);
+    EXPECT_EQ(9, GraphLib::algorithm::distanceWithoutWeight(g, 0, 9));
+}
+
+// PageRank
+TEST(GraphTest, PageRank) {
+    Graph<Vertex<void>> cycle;
+    for(int i = 1; i <= 3; i++) {
+        cycle.addVertex(Vertex<void>(i));
+    }
+    cycle.addEdge(Edge(1, 1, 2));
+    cycle.addEdge(Edge(2, 2, 3));
+    cycle.addEdge(Edge(3, 3, 1));
+    auto pr = GraphLib::algorithm::pageRank(cycle);
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), pr.ids);
+    for(double r: pr.ranks) {
+        EXPECT_NEAR(1.0 / 3, r, 1e-9);
+    }
+
+    // 星形无向图: 中心与叶子满足平稳方程
+    UndirectedGraph<Vertex<void>> star;
+    for(int i = 1; i <= 4; i++) {
+        star.addVertex(Vertex<void>(i));
+    }
+    for(int i = 2; i <= 4; i++) {
+        star.addEdge(Edge(i, 1, i));
+    }
+    GraphLib::algorithm::PageRankOptions options;
+    options.maxIterations = 1000;
+    GraphLib::parallel::ThreadPool pool(3);
+    auto starPr = GraphLib::algorithm::pageRank(GraphLib::execution::on(pool), star, options);
+    EXPECT_LT(starPr.iterations, options.maxIterations);
+    double center = starPr.ranks[0], leaf = starPr.ranks[1];
+    EXPECT_NEAR(0.15 / 4 + 0.85 * 3 * leaf, center, 1e-9);
+    EXPECT_NEAR(1.0, center + 3 * leaf, 1e-9);
+
+    // 悬挂顶点的分数不会丢失
+    Graph<Vertex<void>> chain;
+    for(int i = 1; i <= 3; i++) {
+        chain.addVertex(Vertex<void>(i));
+    }
+    chain.addEdge(Edge(1, 1, 2));
+    chain.addEdge(Edge(2, 1, 3, 3));
+    auto chainPr = GraphLib::algorithm::pageRank(chain);
+    EXPECT_NEAR(1.0, chainPr.ranks[0] + chainPr.ranks[1] + chainPr.ranks[2], 1e-9);
+    EXPECT_NEAR(chainPr.ranks[1], chainPr.ranks[2], 1e-9);
+    options.weighted = true;
+    auto weightedPr = GraphLib::algorithm::pageRank(chain, options);
+    EXPECT_GT(weightedPr.ranks[2], weightedPr.ranks[1]);
+
+    // 个性化 PageRank: 批量结果与逐个计算一致
+    auto seeded = GraphLib::algorithm::personalizedPageRank(star, {2}, options);
+    EXPECT_GT(seeded.ranks[1], seeded.ranks[2]);
+    EXPECT_NEAR(seeded.ranks[2], seeded.ranks[3], 1e-12);
+    auto batch = GraphLib::algorithm::personalizedPageRankBatch(star, {{2}, {3, 4}}, options);
+    ASSERT_EQ(2, batch.size());
+    for(int v = 0; v < 4; v++) {
+        EXPECT_NEAR(seeded.ranks[v], batch[0].ranks[v], 1e-9);
+    }
+    EXPECT_NEAR(batch[1].ranks[2], batch[1].ranks[3], 1e-12);
+    EXPECT_THROW(GraphLib::algorithm::personalizedPageRank(star, {42}), std::runtime_error);
+
+    // 幂律式的入度: 少数枢纽接收大部分边. 并行结果与顺序结果一致,
+    // 超过一组宽度的批量 (11 组种子) 与逐个计算一致
+    Graph<Vertex<void>> hubs;
+    const int n = 500;
+    for(int i = 0; i < n; i++) {
+        hubs.addVertex(Vertex<void>(i));
+    }
+    int eid = 0;
+    for(int i = 0; i < n; i++) {
+        for(int hub = 0; hub < 4; hub++) {
+            if(i % (hub + 1) == 0 && i != hub)
+                hubs.addEdge(Edge(eid++, i, hub));
+        }
+        if(i % 3)
+            hubs.addEdge(Edge(eid++, i, (i * 7 + 1) % n));
+    }
+    GraphLib::algorithm::PageRankOptions hubOptions;
+    hubOptions.maxIterations = 1000;
+    auto sequentialPr = GraphLib::algorithm::pageRank(hubs, hubOptions);
+    auto parallelPr = GraphLib::algorithm::pageRank(GraphLib::execution::on(pool), hubs, hubOptions);
+    EXPECT_EQ(sequentialPr.iterations, parallelPr.iterations);
+    for(int v = 0; v < n; v++) {
+        EXPECT_NEAR(sequentialPr.ranks[v], parallelPr.ranks[v], 1e-12);
+    }
+    std::vector<std::vector<int>> seedSets;
+    for(int j = 0; j < 11; j++) {
+        seedSets.push_back({j * 17 % n, j * 31 % n});
+    }
+    auto hubBatch = GraphLib::algorithm::personalizedPageRankBatch(GraphLib::execution::on(pool), hubs,
+                                                                   seedSets, hubOptions);
+    ASSERT_EQ(11, hubBatch.size());
+    for(int j = 0; j < 11; j++) {
+        auto single = GraphLib::algorithm::personalizedPageRank(hubs, seedSets[j], hubOptions);
+        EXPECT_EQ(single.ids, hubBatch[j].ids);
+        double sum = 0;
+        for(int v = 0; v < n; v++) {
+            EXPECT_NEAR(single.ranks[v], hubBatch[j].ranks[v], 1e-9);
+            sum += hubBatch[j].ranks[v];
+        }
+        EXPECT_NEAR(1.0, sum, 1e-9);
+    }
+}
+
+// k-core 分解
+TEST(GraphTest, CoreDecomposition) {
+    UndirectedGraph<Vertex<void>> g;
+    for(int i = 1; i <= 8; i++) {
+        g.addVertex(Vertex<void>(i));
+    }
+    // 1..4 是 K4, 5, 6, 7 挂在外面, 8 孤立
+    int eid = 0;
+    for(int u = 1; u <= 4; u++) {
+        for(int v = u + 1; v <= 4; v++) {
+            g.addEdge(Edge(eid++, u, v));
+        }
+    }
+    g.addEdge(Edge(eid++, 4, 5));
+    g.addEdge(Edge(eid++, 5, 6));
+    g.addEdge(Edge(eid++, 6, 4));
+    g.addEdge(Edge(eid++, 6, 7));
+
+    auto cores = GraphLib::algorithm::coreDecomposition(g);
+    EXPECT_EQ((std::vector<int>{3, 3, 3, 3, 2, 2, 1, 0}), cores.coreness);
+    EXPECT_EQ(3, cores.degeneracy);
+    EXPECT_EQ(-1, cores.corenessOf(42));
+
+    // 退化序中每个顶点排在它后面的邻居不超过 degeneracy 个
+    std::unordered_map<int, int> position;
+    for(int i = 0; i < cores.order.size(); i++) {
+        position[cores.order[i]] = i;
+    }
+    for(int v = 1; v <= 8; v++) {
+        int later = 0;
+        auto edgeIds = g.getEdgeIdsOfVertex(v);
+        for(int e: *edgeIds) {
+            later += position[g.getEdge(e).other(v)] > position[v];
+        }
+        EXPECT_LE(later, cores.degeneracy);
+    }
+
+    GraphLib::parallel::ThreadPool pool(4);
+    auto parallelCores = GraphLib::algorithm::coreDecomposition(GraphLib::execution::on(pool), g);
+    EXPECT_EQ(cores.coreness, parallelCores.coreness);
+    EXPECT_EQ(cores.degeneracy, parallelCores.degeneracy);
+    EXPECT_EQ(8, parallelCores.order.size());
+
+    auto core3 = GraphLib::algorithm::kCore(g, cores, 3);
+    EXPECT_EQ(4, core3.numVertices());
+    EXPECT_EQ(6, core3.numEdges());
+    EXPECT_EQ(6, GraphLib::algorithm::kCore(g, 2).numVertices());
+
+    // 有向图忽略方向
+    Graph<Vertex<void>> dg;
+    for(int i = 1; i <= 3; i++) {
+        dg.addVertex(Vertex<void>(i));
+    }
+    dg.addEdge(Edge(1, 1, 2));
+    dg.addEdge(Edge(2, 2, 1));
+    dg.addEdge(Edge(3, 2, 3));
+    dg.addEdge(Edge(4, 3, 1));
+    EXPECT_EQ((std::vector<int>{2, 2, 2}), GraphLib::algorithm::coreDecomposition(dg).coreness);
+}
+
+// 顶点重排
+TEST(GraphTest, Reorder) {
+    using MVertex = Vertex<int>;
+    // 一条路径, 顶点 id 打乱
+    const std::vector<int> path = {40, 7, 93, 12, 58, 3, 71, 25};
+    UndirectedGraph<MVertex> g;
+    for(int id: path) {
+        g.addVertex(MVertex(id, id * 10));
+    }
+    for(int i = 0; i + 1 < path.size(); i++) {
+        g.addEdge(Edge(100 + i, path[i], path[i + 1]));
+    }
+    g.addVertex(MVertex(1000, 0));
+    g.addVertex(MVertex(1001, 0));
+    g.addEdge(Edge(200, 1000, 1001));
+    g.addEdge(Edge(201, 1000, 40));
+
+    auto isPermutation = [&](std::vector<int> order) {
+        std::sort(order.begin(), order.end());
+        auto ids = path;
+        ids.push_back(1000);
+        ids.push_back(1001);
+        std::sort(ids.begin(), ids.end());
+        return order == ids;
+    };
+    auto degree = GraphLib::algorithm::degreeOrder(g);
+    EXPECT_TRUE(isPermutation(degree));
+    EXPECT_EQ(3, degree[0]);
+    EXPECT_EQ(25, degree[8]);
+    EXPECT_EQ(1001, degree[9]);
+    EXPECT_TRUE(isPermutation(GraphLib::algorithm::bfsOrder(g)));
+    EXPECT_TRUE(isPermutation(GraphLib::algorithm::gorderOrder(g)));
+
+    // 网格上 gorder 仍是排列, 且大多数相邻位置的顶点在图中相邻或有共同邻居
+    UndirectedGraph<Vertex<void>> grid;
+    const int side = 30;
+    for(int i = 0; i < side * side; i++) {
+        grid.addVertex(Vertex<void>(i));
+    }
+    for(int r = 0; r < side; r++) {
+        for(int c = 0; c < side; c++) {
+            if(c + 1 < side)
+                grid.addEdge(Edge(2 * (r * side + c), r * side + c, r * side + c + 1));
+            if(r + 1 < side)
+                grid.addEdge(Edge(2 * (r * side + c) + 1, r * side + c, (r + 1) * side + c));
+        }
+    }
+    auto gridOrder = GraphLib::algorithm::gorderOrder(grid);
+    auto sortedOrder = gridOrder;
+    std::sort(sortedOrder.begin(), sortedOrder.end());
+    std::vector<int> allIds(side * side);
+    std::iota(allIds.begin(), allIds.end(), 0);
+    EXPECT_EQ(allIds, sortedOrder);
+    int close = 0;
+    for(int i = 0; i + 1 < gridOrder.size(); i++) {
+        int a = gridOrder[i], b = gridOrder[i + 1];
+        close += std::abs(a / side - b / side) + std::abs(a % side - b % side) <= 2;
+    }
+    EXPECT_GT(close, side * side * 9 / 10);
+
+    // RCM 把路径排成带宽为 1
+    auto rcm = GraphLib::algorithm::rcmOrder(g);
+    ASSERT_TRUE(isPermutation(rcm));
+    auto relabeled = GraphLib::algorithm::relabel(g, rcm);
+    EXPECT_EQ(rcm, relabeled.mapping.vertexIds);
+    UndirectedGraph<MVertex> r(std::move(relabeled.data));
+    EXPECT_EQ(10, r.numVertices());
+    EXPECT_EQ(9, r.numEdges());
+    for(int eid = 0; eid < r.numEdges(); eid++) {
+        const auto& e = r.getEdge(eid);
+        EXPECT_EQ(1, std::abs(e.from - e.to));
+        const auto& old = g.getEdge(relabeled.mapping.edgeIds[eid]);
+        EXPECT_EQ(old.from, relabeled.mapping.vertexIds[e.from]);
+        EXPECT_EQ(old.to, relabeled.mapping.vertexIds[e.to]);
+    }
+    for(int v = 0; v < r.numVertices(); v++) {
+        if(relabeled.mapping.vertexIds[v] < 1000)
+            EXPECT_EQ(relabeled.mapping.vertexIds[v] * 10, r.getVertex(v).data);
+    }
+    auto newIdOf = [&](int id) {
+        auto& ids = relabeled.mapping.vertexIds;
+        return int(std::find(ids.begin(), ids.end(), id) - ids.begin());
+    };
+    EXPECT_EQ(GraphLib::algorithm::distanceWithoutWeight(g, 1001, 25),
+              GraphLib::algorithm::distanceWithoutWeight(r, newIdOf(1001), newIdOf(25)));
+
+    EXPECT_THROW(GraphLib::algorithm::relabel(g, {40, 7}), std::runtime_error);
+}
+
+// 分片与跨分片 BSP 遍历
+TEST(GraphTest, ShardedTraversal) {
+    UndirectedGraph<Vertex<void>> g;
+    // 两个 6 顶点的环用一条边连起来, 再加一个单独的三角形
+    for(int i = 0; i < 15; i++) {
+        g.addVertex(Vertex<void>(i));
+    }
+    int eid = 0;
+    for(int c = 0; c < 2; c++) {
+        for(int i = 0; i < 6; i++) {
+            g.addEdge(Edge(eid++, c * 6 + i, c * 6 + (i + 1) % 6));
+        }
+    }
+    g.addEdge(Edge(eid++, 5, 6));
+    g.addEdge(Edge(eid++, 12, 13));
+    g.addEdge(Edge(eid++, 13, 14));
+    g.addEdge(Edge(eid++, 14, 12));
+
+    const auto csr = toCsr(g);
+    const auto partitioning = partitionLdg(csr, 3);
+    std::vector<int> sizes(3, 0);
+    for(int owner: partitioning.owner) {
+        sizes[owner]++;
+    }
+    for(int size: sizes) {
+        EXPECT_LE(size, 6);
+    }
+    EXPECT_LT(cutArcs(csr, partitioning), csr.numArcs() / 2);
+
+    auto shards = buildShards(csr, partitioning);
+    ASSERT_EQ(3, shards.size());
+    int owned = 0, ghosts = 0;
+    for(const auto& shard: shards) {
+        owned += shard.numLocal;
+        ghosts += shard.numGhosts();
+        for(int local = shard.numLocal; local < shard.globalIds.size(); local++) {
+            EXPECT_NE(shard.shardId, shard.ownerOf(local));
+        }
+    }
+    EXPECT_EQ(15, owned);
+    EXPECT_GT(ghosts, 0);
+
+    auto dist = GraphLib::algorithm::distributedBfs(shards, 0);
+    ASSERT_EQ(15, dist.size());
+    for(int v = 1; v < 12; v++) {
+        EXPECT_EQ(GraphLib::algorithm::distanceWithoutWeight(g, 0, v), dist[v]);
+    }
+    EXPECT_EQ(0, dist[0]);
+    EXPECT_EQ(-1, dist[13]);
+
+    auto components = GraphLib::algorithm::distributedConnectedComponents(shardGraph(g, 4));
+    for(int v = 0; v < 12; v++) {
+        EXPECT_EQ(0, components[v]);
+    }
+    for(int v = 12; v < 15; v++) {
+        EXPECT_EQ(12, components[v]);
+    }
+
+    // 一个分片出错时其它分片不会在屏障处永远等待, 抛出的是最先发生的异常
+    for(int failing = 0; failing < shards.size(); failing++) {
+        auto runner = [&](const Shard& shard, InProcessTransport& transport) {
+            for(int step = 0; step < 5; step++) {
+                if(shard.shardId == failing && step == 2)
+                    throw std::invalid_argument("shard failed");
+                transport.sync(shard.shardId, true);
+            }
+            return std::vector<int>(shard.numLocal, 0);
+        };
+        EXPECT_THROW(GraphLib::algorithm::runShardsInProcess(shards, runner), std::invalid_argument);
+    }
+}
+
+// 惰性遍历
+TEST(GraphTest, LazyTraversal) {
+    UndirectedGraph<Vertex<void>> path;
+    const int n = 100000;
+    for(int i = 0; i < n; i++) {
+        path.addVertex(Vertex<void>(i));
+        if(i > 0)
+            path.addEdge(Edge(i, i - 1, i));
+    }
+    // 只取前几个结果, 不会走完整条路径
+    std::vector<std::pair<int, int>> firstHits;
+    for(auto hit: GraphLib::algorithm::kHopNeighborhood(path, 500, 1000)) {
+        firstHits.push_back(hit);
+        if(firstHits.size() == 4)
+            break;
+    }
+    ASSERT_EQ(4, firstHits.size());
+    EXPECT_EQ(1, firstHits[0].second);
+    EXPECT_EQ(1, firstHits[1].second);
+    EXPECT_EQ(2, firstHits[2].second);
+    EXPECT_EQ(2, firstHits[3].second);
+
+    std::vector<int> pre, post;
+    for(int v: GraphLib::algorithm::dfsPreorder(path, 0)) {
+        pre.push_back(v);
+        if(pre.size() == 3)
+            break;
+    }
+    EXPECT_EQ((std::vector<int>{0, 1, 2}), pre);
+
+    Graph<Vertex<void>> tree;
+    for(int i = 1; i <= 5; i++) {
+        tree.addVertex(Vertex<void>(i));
+    }
+    tree.addEdge(Edge(1, 1, 2));
+    tree.addEdge(Edge(2, 2, 3));
+    tree.addEdge(Edge(3, 1, 4));
+    tree.addEdge(Edge(4, 4, 5));
+    for(int v: GraphLib::algorithm::dfsPostorder(tree, 1)) {
+        post.push_back(v);
+    }
+    ASSERT_EQ(5, post.size());
+    EXPECT_EQ(1, post.back());
+    auto before = [&](int a, int b) {
+        return std::find(post.begin(), post.end(), a) < std::find(post.begin(), post.end(), b);
+    };
+    EXPECT_TRUE(before(3, 2));
+    EXPECT_TRUE(before(5, 4));
+
+    std::vector<std::vector<int>> levels;
+    for(auto level: GraphLib::algorithm::bfsLevels(tree, 1)) {
+        std::sort(level.begin(), level.end());
+        levels.push_back(level);
+    }
+    EXPECT_EQ((std::vector<std::vector<int>>{{1}, {2, 4}, {3, 5}}), levels);
+    int count = 0;
+    for(auto level: GraphLib::algorithm::bfsLevels(tree, 42)) {
+        count += level.size();
+    }
+    EXPECT_EQ(0, count);
+}
+
+// 按 epoch 失效的查询缓存
+TEST(GraphTest, QueryCache) {
+    UndirectedGraph<Vertex<void>> g;
+    for(int i = 1; i <= 5; i++) {
+        g.addVertex(Vertex<void>(i));
+    }
+    for(int i = 1; i < 5; i++) {
+        g.addEdge(Edge(i, i, i + 1));
+    }
+    QueryCache cache(1 << 20);
+    auto epoch = g.epoch();
+    EXPECT_EQ(4, GraphLib::algorithm::cachedDistanceWithoutWeight(cache, g, 1, 5));
+    EXPECT_EQ(4, GraphLib::algorithm::cachedDistanceWithoutWeight(cache, g, 1, 5));
+    EXPECT_EQ((std::vector<int>{2, 3, 4}), *GraphLib::algorithm::cachedTarjan(cache, g));
+    auto bipartite = GraphLib::algorithm::cachedIsBipartite(cache, g);
+    EXPECT_TRUE(bipartite->has_value());
+    // 命中时返回同一份结果, 不复制
+    EXPECT_EQ(bipartite, GraphLib::algorithm::cachedIsBipartite(cache, g));
+    EXPECT_EQ(2, cache.hits());
+    EXPECT_EQ(3, cache.misses());
+    EXPECT_EQ(3, cache.size());
+
+    // 修改后旧结果失效
+    EXPECT_FALSE(g.delEdge(42));
+    EXPECT_EQ(epoch, g.epoch());
+    g.addEdge(Edge(5, 1, 5));
+    EXPECT_GT(g.epoch(), epoch);
+    EXPECT_EQ(1, GraphLib::algorithm::cachedDistanceWithoutWeight(cache, g, 1, 5));
+    EXPECT_FALSE(GraphLib::algorithm::cachedIsBipartite(cache, g)->has_value());
+    EXPECT_TRUE(bipartite->has_value());
+    EXPECT_EQ(2, cache.size());
+
+    // 不同的图互不干扰
+    UndirectedGraph<Vertex<void>> other;
+    EXPECT_NE(g.instanceId(), other.instanceId());
+    other.addVertex(Vertex<void>(1));
+    other.addVertex(Vertex<void>(5));
+    EXPECT_EQ(-1, GraphLib::algorithm::cachedDistanceWithoutWeight(cache, other, 1, 5));
+    EXPECT_EQ(2, cache.numGraphs());
+    cache.invalidate(other.instanceId());
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(1, cache.numGraphs());
+
+    // 超出内存上限时淘汰最久未用的结果
+    QueryCache small(3 * approximateBytes(std::vector<int>(64)) + 1024);
+    for(int i = 0; i < 20; i++) {
+        small.getOrCompute<std::vector<int>>("range", {i}, g, [] { return std::vector<int>(64); });
+        EXPECT_LE(small.bytes(), 3 * approximateBytes(std::vector<int>(64)) + 1024);
+    }
+    EXPECT_GT(small.size(), 0);
+    EXPECT_LT(small.size(), 20);
+    small.getOrCompute<std::vector<int>>("range", {19}, g, [] { return std::vector<int>(); });
+    EXPECT_EQ(1, small.hits());
+
+    // 许多短命的图: 结果被淘汰后, 每张图的簿记也随之删除, 不会无限增长
+    for(int i = 0; i < 100; i++) {
+        UndirectedGraph<Vertex<void>> temporary;
+        temporary.addVertex(Vertex<void>(1));
+        small.getOrCompute<std::vector<int>>("range", {i}, temporary, [] { return std::vector<int>(64); });
+        EXPECT_LE(small.numGraphs(), small.size());
+    }
+    small.clear();
+    EXPECT_EQ(0, small.numGraphs());
+}
+
+// 位并行多源 BFS
+TEST(GraphTest, MultiSourceBfs) {
+    Graph<Vertex<void>> g;
+    const int n = 90;
+    for(int i = 0; i < n; i++) {
+        g.addVertex(Vertex<void>(i * 2));
+    }
+    int eid = 0;
+    for(int i = 0; i < n; i++) {
+        g.addEdge(Edge(eid++, i * 2, (i + 1) % n * 2));
+        if(i % 7 == 0)
+            g.addEdge(Edge(eid++, i * 2, (i * 13 + 5) % n * 2));
+    }
+    g.addVertex(Vertex<void>(1000));
+
+    std::vector<int> sources;
+    for(int i = 0; i < n; i++) {
+        sources.push_back(i * 2);
+    }
+    sources.push_back(1000);
+    sources.push_back(-7);
+    // Words = 1 时一批 64 个源点, 这里分成两批并行
+    GraphLib::parallel::ThreadPool pool(2);
+    auto matrix = GraphLib::algorithm::multiSourceDistances<1>(GraphLib::execution::on(pool), g, sources);
+    ASSERT_EQ(n + 1, matrix.ids.size());
+    for(int s = 0; s < sources.size(); s++) {
+        for(int v = 0; v < matrix.ids.size(); v++) {
+            int expected = -1;
+            if(sources[s] >= 0)
+                expected = GraphLib::algorithm::distanceWithoutWeight(g, sources[s], matrix.ids[v]);
+            EXPECT_EQ(expected, matrix.at(s, v));
+        }
+    }
+
+    std::mutex mutex;
+    int reports = 0, maxDistance = 0;
+    GraphLib::algorithm::multiSourceBfs(GraphLib::execution::on(pool), g, sources, [&](int source, int vertex, int distance) {
+        std::lock_guard lock(mutex);
+        reports++;
+        maxDistance = std::max(maxDistance, distance);
+    });
+    EXPECT_EQ(n * n + 1, reports);
+    EXPECT_EQ(*std::max_element(matrix.dist.begin(), matrix.dist.end()), maxDistance);
+
+    // 长路径接一个大星形: 路径上前沿很小走自顶向下, 到达中心后前沿变大改为自底向上, 之后再切回
+    UndirectedGraph<Vertex<void>> mixed;
+    const int pathLength = 300, leaves = 400;
+    for(int i = 0; i < pathLength + leaves; i++) {
+        mixed.addVertex(Vertex<void>(i));
+    }
+    for(int i = 0; i + 1 < pathLength; i++) {
+        mixed.addEdge(Edge(i, i, i + 1));
+    }
+    for(int i = 0; i < leaves; i++) {
+        mixed.addEdge(Edge(pathLength + i, pathLength - 1, pathLength + i));
+    }
+    mixed.addEdge(Edge(pathLength + leaves, pathLength + 7, 0));
+    std::vector<int> mixedSources = {0, 150, 150, pathLength - 1, pathLength + 3};
+    auto mixedMatrix = GraphLib::algorithm::multiSourceDistances<1>(mixed, mixedSources);
+    for(int s = 0; s < mixedSources.size(); s++) {
+        for(int v = 0; v < mixedMatrix.ids.size(); v++) {
+            EXPECT_EQ(GraphLib::algorithm::distanceWithoutWeight(mixed, mixedSources[s], mixedMatrix.ids[v]),
+                      mixedMatrix.at(s, v));
+        }
+    }
+}
+
+// 剪枝地标标签距离索引
+template <typename G>
+void expectSameDistances(const G& graph, const GraphLib::DistanceIndex& index, int n) {
+    std::vector<int> sources(n);
+    std::iota(sources.begin(), sources.end(), 0);
+    auto matrix = GraphLib::algorithm::multiSourceDistances(graph, sources);
+    for(int s = 0; s < n; s++) {
+        for(int t = 0; t < n; t++) {
+            EXPECT_EQ(matrix.at(s, t), index.distance(s, t));
+            EXPECT_EQ(matrix.at(s, t), GraphLib::algorithm::distanceWithoutWeight(graph, s, t));
+        }
+    }
+}
+
+TEST(GraphTest, DistanceIndex) {
+    const int n = 60;
+    Graph<Vertex<void>> directed;
+    UndirectedGraph<Vertex<void>> undirected;
+    for(int i = 0; i < n; i++) {
+        directed.addVertex(Vertex<void>(i));
+        undirected.addVertex(Vertex<void>(i));
+    }
+    unsigned seed = 7;
+    auto next = [&] { return (seed = seed * 1103515245 + 12345) >> 16; };
+    for(int e = 0; e < 90; e++) {
+        int from = next() % n, to = next() % n;
+        directed.addEdge(Edge(e, from, to));
+        undirected.addEdge(Edge(e, from, to));
+    }
+
+    GraphLib::parallel::ThreadPool pool(3);
+    auto checkIndexes = [&](const auto& policy) {
+        auto directedIndex = GraphLib::buildDistanceIndex(policy, directed);
+        EXPECT_TRUE(directedIndex.isDirected());
+        expectSameDistances(directed, directedIndex, n);
+        auto undirectedIndex = GraphLib::buildDistanceIndex(policy, undirected);
+        EXPECT_FALSE(undirectedIndex.isDirected());
+        expectSameDistances(undirected, undirectedIndex, n);
+    };
+    checkIndexes(GraphLib::execution::seq);
+    checkIndexes(GraphLib::execution::on(pool));
+    auto index = GraphLib::buildDistanceIndex(directed);
+    EXPECT_THROW((void)index.distance(0, n), std::runtime_error);
+
+    auto path = (std::filesystem::temp_directory_path() / "graphlib_pll_test.idx").string();
+    ASSERT_TRUE(index.save(path));
+    auto loaded = GraphLib::DistanceIndex::load(path);
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(index.numLabelEntries(), loaded->numLabelEntries());
+    expectSameDistances(directed, *loaded, n);
+
+    // 增量插入新边后与重新 BFS 的结果一致
+    std::vector<std::pair<int, int>> added;
+    for(int e = 90; e < 110; e++) {
+        int from = next() % n, to = next() % n;
+        directed.addEdge(Edge(e, from, to));
+        added.emplace_back(from, to);
+    }
+    loaded->addEdges(added);
+    expectSameDistances(directed, *loaded, n);
+
+    // 截断或损坏的文件返回 EINVAL, 而不是载入一个会越界访问的索引
+    std::string bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), {});
+    }
+    auto loadBytes = [&](const std::string& content) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+        return GraphLib::DistanceIndex::load(path);
+    };
+    for(size_t size = 0; size < bytes.size(); size += 3) {
+        EXPECT_EQ(EINVAL, loadBytes(bytes.substr(0, size)).error());
+    }
+    // 除了顶点 id 本身, 任何一个 4 字节字段 (长度、偏移、hub、距离、哨兵、邻接) 改坏都会被发现
+    int accepted = 0;
+    for(size_t pos = 12; pos + 4 <= bytes.size(); pos += 4) {
+        std::string corrupted = bytes;
+        const int garbage = 1 << 30;
+        std::memcpy(corrupted.data() + pos, &garbage, sizeof(garbage));
+        auto result = loadBytes(corrupted);
+        if(result)
+            accepted++;
+        else
+            EXPECT_EQ(EINVAL, result.error());
+    }
+    EXPECT_EQ(n, accepted);
+    std::filesystem::remove(path);
+
+    auto undirectedIndex = GraphLib::buildDistanceIndex(GraphLib::execution::par, undirected);
+    for(int e = 90; e < 110; e++) {
+        int from = next() % n, to = next() % n;
+        undirected.addEdge(Edge(e, from, to));
+        undirectedIndex.addEdges({{from, to}});
+    }
+    expectSameDistances(undirected, undirectedIndex, n);
+
+    EXPECT_EQ(ENOENT, GraphLib::DistanceIndex::load(path).error());
+}
+
+// 强连通分量
+TEST(GraphTest, StronglyConnectedComponents) {
+    Graph<Vertex<void>> g;
+    for(int i = 1; i <= 8; i++) {
+        g.addVertex(Vertex<void>(i));
+    }
+    // {1, 2, 3} -> {4, 5} -> 6, 7 自环, 8 孤立
+    g.addEdge(Edge(1, 1, 2));
+    g.addEdge(Edge(2, 2, 3));
+    g.addEdge(Edge(3, 3, 1));
+    g.addEdge(Edge(4, 3, 4));
+    g.addEdge(Edge(5, 2, 4));
+    g.addEdge(Edge(6, 4, 5));
+    g.addEdge(Edge(7, 5, 4));
+    g.addEdge(Edge(8, 5, 6));
+    g.addEdge(Edge(9, 7, 7));
+    GraphLib::parallel::ThreadPool pool(3);
+    for(const auto& scc: {GraphLib::algorithm::stronglyConnectedComponents(g),
+                          GraphLib::algorithm::stronglyConnectedComponents(GraphLib::execution::on(pool), g)}) {
+        EXPECT_EQ(5, scc.numComponents);
+        EXPECT_EQ(scc.componentOf(1), scc.componentOf(3));
+        EXPECT_EQ(scc.componentOf(4), scc.componentOf(5));
+        EXPECT_LT(scc.componentOf(1), scc.componentOf(4));
+        EXPECT_LT(scc.componentOf(4), scc.componentOf(6));
+        EXPECT_NE(scc.componentOf(7), scc.componentOf(8));
+        EXPECT_EQ(-1, scc.componentOf(9));
+        // 两条 {1,2,3} -> {4,5} 的边合并成一条
+        int from = scc.componentOf(1);
+        ASSERT_EQ(1, scc.condensation.degree(from));
+        EXPECT_EQ(scc.componentOf(4), scc.condensation.neighbors(from)[0]);
+        EXPECT_EQ(2, scc.condensation.weightsOf(from)[0]);
+    }
+
+    // 随机图上与两两可达性比较
+    Graph<Vertex<void>> random;
+    const int n = 300;
+    for(int i = 0; i < n; i++) {
+        random.addVertex(Vertex<void>(i));
+    }
+    unsigned seed = 11;
+    auto next = [&] { return (seed = seed * 1103515245 + 12345) >> 16; };
+    for(int e = 0; e < 420; e++) {
+        random.addEdge(Edge(e, next() % n, next() % n));
+    }
+    std::vector<int> sources(n);
+    std::iota(sources.begin(), sources.end(), 0);
+    auto reach = GraphLib::algorithm::multiSourceDistances(random, sources);
+    auto sequential = GraphLib::algorithm::stronglyConnectedComponents(random);
+    auto parallel = GraphLib::algorithm::stronglyConnectedComponents(GraphLib::execution::par, random);
+    EXPECT_EQ(sequential.numComponents, parallel.numComponents);
+    for(const auto* scc: {&sequential, &parallel}) {
+        for(int u = 0; u < n; u++) {
+            for(int v = 0; v < n; v++) {
+                bool strong = reach.at(u, v) >= 0 && reach.at(v, u) >= 0;
+                EXPECT_EQ(strong, scc->component[u] == scc->component[v]);
+            }
+        }
+        for(int c = 0; c < scc->numComponents; c++) {
+            for(int d: scc->condensation.neighbors(c)) {
+                EXPECT_LT(c, d);
+            }
+        }
+    }
+}
+
+// 最大流与最小割
+TEST(GraphTest, MaxFlow) {
+    // 算法导论中的例子, 最大流为 23
+    Graph<Vertex<void>> g;
+    for(int i = 0; i < 6; i++) {
+        g.addVertex(Vertex<void>(i));
+    }
+    g.addEdge(Edge(1, 0, 1, 16));
+    g.addEdge(Edge(2, 0, 2, 13));
+    g.addEdge(Edge(3, 2, 1, 4));
+    g.addEdge(Edge(4, 1, 3, 12));
+    g.addEdge(Edge(5, 3, 2, 9));
+    g.addEdge(Edge(6, 2, 4, 14));
+    g.addEdge(Edge(7, 4, 3, 7));
+    g.addEdge(Edge(8, 3, 5, 20));
+    g.addEdge(Edge(9, 4, 5, 4));
+    auto network = GraphLib::algorithm::toFlowNetwork(g);
+    GraphLib::parallel::ThreadPool pool(3);
+    for(const auto& result: {GraphLib::algorithm::maxFlow(g, 0, 5),
+                             GraphLib::algorithm::dinicMaxFlow(network, 0, 5),
+                             GraphLib::algorithm::maxFlow(GraphLib::execution::on(pool), g, 0, 5)}) {
+        EXPECT_EQ(23, result.flow);
+        EXPECT_EQ((std::vector<int>{0, 1, 2, 4}), result.sourceSide);
+        EXPECT_EQ((std::vector<int>{4, 7, 9}), result.cutEdges);
+    }
+    EXPECT_THROW(GraphLib::algorithm::maxFlow(g, 0, 0), std::runtime_error);
+    EXPECT_THROW(GraphLib::algorithm::maxFlow(g, 0, 42), std::runtime_error);
+
+    // 端点没有用 addVertex 加入的边被忽略, 与 toCsr 一致
+    Graph<Vertex<void>> partial;
+    partial.addVertex(Vertex<void>(0));
+    partial.addVertex(Vertex<void>(1));
+    partial.addEdge(Edge(1, 0, 1, 3));
+    partial.addEdge(Edge(2, 0, 7, 5));
+    partial.addEdge(Edge(3, 7, 1, 5));
+    partial.addEdge(Edge(4, 8, 9, 5));
+    auto partialNetwork = GraphLib::algorithm::toFlowNetwork(partial);
+    EXPECT_EQ(2, partialNetwork.numVertices());
+    EXPECT_EQ(2, partialNetwork.numArcs());
+    for(const auto& result: {GraphLib::algorithm::maxFlow(partial, 0, 1),
+                             GraphLib::algorithm::dinicMaxFlow(partialNetwork, 0, 1),
+                             GraphLib::algorithm::maxFlow(GraphLib::execution::on(pool), partial, 0, 1)}) {
+        EXPECT_EQ(3, result.flow);
+        EXPECT_EQ((std::vector<int>{1}), result.cutEdges);
+    }
+    Graph<Vertex<void>> edgesOnly;
+    edgesOnly.addEdge(Edge(1, 0, 1, 3));
+    edgesOnly.addEdge(Edge(2, 1, 2, 4));
+    EXPECT_EQ(0, GraphLib::algorithm::toFlowNetwork(edgesOnly).numArcs());
+    EXPECT_THROW(GraphLib::algorithm::maxFlow(edgesOnly, 0, 2), std::runtime_error);
+
+    // 随机的有向与无向网络, 三种引擎的流量和最小割一致, 割边容量之和等于流量
+    const int n = 200;
+    Graph<Vertex<void>> directed;
+    UndirectedGraph<Vertex<void>> undirected;
+    for(int i = 0; i < n; i++) {
+        directed.addVertex(Vertex<void>(i));
+        undirected.addVertex(Vertex<void>(i));
+    }
+    unsigned seed = 5;
+    auto next = [&] { return (seed = seed * 1103515245 + 12345) >> 16; };
+    for(int e = 0; e < 1200; e++) {
+        int from = next() % n, to = next() % n, capacity = next() % 50;
+        directed.addEdge(Edge(e, from, to, capacity));
+        undirected.addEdge(Edge(e, from, to, capacity));
+    }
+    auto check = [&](const auto& graph) {
+        auto network = GraphLib::algorithm::toFlowNetwork(graph);
+        for(int round = 0; round < 5; round++) {
+            int source = next() % n, sink = next() % n;
+            if(source == sink)
+                continue;
+            auto expected = GraphLib::algorithm::pushRelabelMaxFlow(network, source, sink);
+            int64_t cut = 0;
+            for(int e: expected.cutEdges) {
+                cut += graph.getEdge(e).weight;
+            }
+            EXPECT_EQ(expected.flow, cut);
+            for(const auto& result: {GraphLib::algorithm::dinicMaxFlow(network, source, sink),
+                                     GraphLib::algorithm::pushRelabelMaxFlow(GraphLib::execution::on(pool), network, source, sink)}) {
+                EXPECT_EQ(expected.flow, result.flow);
+                EXPECT_EQ(expected.sourceSide, result.sourceSide);
+                EXPECT_EQ(expected.cutEdges, result.cutEdges);
+            }
+        }
+    };
+    check(directed);
+    check(undirected);
+}
+
+// 工作窃取线程池与执行策略
+TEST(GraphTest, ThreadPool) {
+    GraphLib::parallel::ThreadPool pool(4);
+    auto policy = GraphLib::execution::on(pool);
+    EXPECT_EQ(4, pool.size());
+    EXPECT_EQ(1, GraphLib::parallel::concurrency(GraphLib::execution::seq));
+    EXPECT_EQ(4, GraphLib::parallel::concurrency(policy));
+
+    // 每个下标恰好处理一次
+    const int n = 100000;
+    std::vector<std::atomic<int>> hits(n);
+    GraphLib::parallel::parallelFor(policy, 0, n, [&](int lo, int hi) {
+        for(int i = lo; i < hi; i++) {
+            hits[i].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    EXPECT_TRUE(std::all_of(hits.begin(), hits.end(), [](const auto& h) { return h.load() == 1; }));
+
+    // 嵌套并行: 任务内部再次 parallelFor 不会死锁
+    std::atomic<int64_t> sum{0};
+    GraphLib::parallel::parallelFor(
+        policy, 0, 16,
+        [&](int lo, int hi) {
+            for(int i = lo; i < hi; i++) {
+                GraphLib::parallel::parallelFor(policy, 0, 1000, [&](int l, int h) {
+                    int64_t local = 0;
+                    for(int j = l; j < h; j++) {
+                        local += j;
+                    }
+                    sum.fetch_add(local, std::memory_order_relaxed);
+                });
+            }
+        },
+        1);
+    EXPECT_EQ(16 * 999 * 1000 / 2, sum.load());
+
+    // 三种策略的规约结果一致, 空区间返回初值
+    auto total = [](const auto& p) {
+        return GraphLib::parallel::parallelReduce(
+            p, 0, n, int64_t(5),
+            [](int lo, int hi) {
+                int64_t s = 0;
+                for(int i = lo; i < hi; i++) {
+                    s += i;
+                }
+                return s;
+            },
+            std::plus<>());
+    };
+    const int64_t expected = 5 + int64_t(n) * (n - 1) / 2;
+    EXPECT_EQ(expected, total(GraphLib::execution::seq));
+    EXPECT_EQ(expected, total(GraphLib::execution::par));
+    EXPECT_EQ(expected, total(policy));
+    EXPECT_EQ(5, GraphLib::parallel::parallelReduce(policy, 3, 3, 5, [](int, int) { return 1; }, std::plus<>()));
+
+    std::vector<int> blockOf(10, -1);
+    GraphLib::parallel::forBlocks(policy, 0, 10, [&](int b, int lo, int hi) {
+        for(int i = lo; i < hi; i++) {
+            blockOf[i] = b;
+        }
+    });
+    EXPECT_TRUE(std::is_sorted(blockOf.begin(), blockOf.end()));
+    EXPECT_EQ(0, blockOf.front());
+    EXPECT_EQ(3, blockOf.back());
+
+    // 任务抛出的异常在等待方重新抛出, 之后池仍可使用
+    EXPECT_THROW(GraphLib::parallel::parallelFor(
+                     policy, 0, n,
+                     [](int lo, int hi) {
+                         if(lo <= n / 2 && n / 2 < hi)
+                             throw std::runtime_error("task failed");
+                     },
+                     64),
+                 std::runtime_error);
+    int calls = 0;
+    GraphLib::parallel::parallelFor(GraphLib::execution::seq, 0, n, [&](int lo, int hi) { calls++; });
+    EXPECT_EQ(1, calls);
+    EXPECT_EQ(expected, total(policy));
+
+    // 顺序算法接受任意策略, 结果与不带策略的调用相同
+    Graph<Vertex<void>> g;
+    for(int i = 0; i < 6; i++) {
+        g.addVertex(Vertex<void>(i));
+    }
+    for(int i = 0; i < 6; i++) {
+        g.addEdge(Edge(i, i, (i + 1) % 6));
+    }
+    EXPECT_EQ(GraphLib::algorithm::tarjan(g), GraphLib::algorithm::tarjan(policy, g));
+    EXPECT_EQ(5, GraphLib::algorithm::distanceWithoutWeight(GraphLib::execution::par, g, 1, 0));
+    EXPECT_EQ(GraphLib::algorithm::rcmOrder(g), GraphLib::algorithm::rcmOrder(policy, g));
+    EXPECT_EQ(GraphLib::algorithm::gorderOrder(g, 3), GraphLib::algorithm::gorderOrder(policy, g, 3));
+    EXPECT_EQ(GraphLib::algorithm::relabel(g, {5, 4, 3, 2, 1, 0}).mapping.edgeIds,
+              GraphLib::algorithm::relabel(policy, g, {5, 4, 3, 2, 1, 0}).mapping.edgeIds);
+    EXPECT_EQ(GraphLib::algorithm::toFlowNetwork(g).heads, GraphLib::algorithm::toFlowNetwork(policy, g).heads);
+    auto cores = GraphLib::algorithm::coreDecomposition(policy, g);
+    EXPECT_EQ(6, GraphLib::algorithm::kCore(policy, g, cores, 1).numVertices());
+    QueryCache cache(1 << 20);
+    EXPECT_EQ(GraphLib::algorithm::tarjan(g), *GraphLib::algorithm::cachedTarjan(policy, cache, g));
+    EXPECT_EQ(GraphLib::algorithm::cachedTarjan(cache, g), GraphLib::algorithm::cachedTarjan(policy, cache, g));
+    EXPECT_EQ(1, GraphLib::algorithm::cachedDistanceWithoutWeight(GraphLib::execution::par, cache, g, 0, 1));
+    EXPECT_TRUE(GraphLib::algorithm::cachedIsBipartite(policy, cache, g)->has_value());
+    EXPECT_EQ(2, cache.hits());
+
+    // 等待中的工作线程在剩余任务较慢时阻塞而不是空转, 任务结束后仍能被唤醒
+    std::atomic<int> slow{0};
+    GraphLib::parallel::parallelFor(
+        policy, 0, 4,
+        [&](int lo, int hi) {
+            GraphLib::parallel::parallelFor(
+                policy, 0, 2,
+                [&](int l, int h) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                    slow.fetch_add(h - l);
+                },
+                1);
+        },
+        1);
+    EXPECT_EQ(8, slow.load());
 }
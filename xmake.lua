@@ -15,6 +15,7 @@ target("graph")
     set_kind("binary")
     add_includedirs("src/graph")
     add_packages("gtest")
+    add_syslinks("pthread")
     add_files("src/**/*.cpp")
     add_files("src/*.cpp")
 